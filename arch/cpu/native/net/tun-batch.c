@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Batched input from a tun device.
+ *
+ *         A tun device returns exactly one packet per read() and has no
+ *         recvmmsg() equivalent, so batching does not save read calls.
+ *         It saves the main loop iteration (select/epoll, process_run()
+ *         and the etimer poll) that each packet would otherwise cost.
+ */
+
+#include "net/ipv6/uip.h"
+#include "net/ipv6/tcpip.h"
+#include "tun-batch.h"
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Tun"
+#define LOG_LEVEL LOG_LEVEL_MAIN
+
+static struct tun_batch_stats stats;
+/*---------------------------------------------------------------------------*/
+void
+tun_batch_init(int fd)
+{
+  int flags;
+
+  if(TUN_BATCH_SIZE > 1 && fd >= 0) {
+    /* Needed to know when the device has been drained */
+    flags = fcntl(fd, F_GETFL);
+    if(flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+      LOG_WARN("Could not make tun non-blocking, reading one packet per wakeup\n");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+tun_batch_input(int fd, int max, int (*has_room)(void))
+{
+  int count;
+  int size;
+
+  if(fd == -1) {
+    /* tun is not open */
+    return 0;
+  }
+  if(max > TUN_BATCH_SIZE) {
+    max = TUN_BATCH_SIZE;
+  }
+
+  for(count = 0; count < max; count++) {
+    if(count > 0 && has_room != NULL && !has_room()) {
+      /* Where the packets go cannot take another one yet */
+      break;
+    }
+    size = read(fd, &uip_buf[UIP_LLH_LEN], UIP_BUFSIZE - UIP_LLH_LEN);
+    if(size == -1) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        break;
+      }
+      err(1, "tun_batch_input: read");
+    }
+    if(size == 0) {
+      break;
+    }
+    uip_len = size;
+    tcpip_input();
+  }
+
+  if(count > 0) {
+    stats.batches++;
+    stats.packets += count;
+    if(count == TUN_BATCH_SIZE) {
+      stats.full++;
+    }
+    if(count > stats.max) {
+      stats.max = count;
+    }
+    LOG_DBG("Batch of %d packets (%lu packets in %lu batches, max %u, %lu full)\n",
+            count, stats.packets, stats.batches, stats.max, stats.full);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+const struct tun_batch_stats *
+tun_batch_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
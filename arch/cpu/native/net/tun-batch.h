@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Batched input from a tun device. Drains several packets per
+ *         main loop wakeup, feeding them back-to-back to tcpip.
+ */
+
+#ifndef TUN_BATCH_H_
+#define TUN_BATCH_H_
+
+#include "contiki.h"
+
+/*
+ * Maximum number of packets read from the tun device per main loop wakeup.
+ * With 1 (the default), a single packet is read per wakeup. Otherwise the
+ * device is set non-blocking and read until it is empty or the batch is full.
+ */
+#ifdef TUN_BATCH_CONF_SIZE
+#define TUN_BATCH_SIZE TUN_BATCH_CONF_SIZE
+#else
+#define TUN_BATCH_SIZE 1
+#endif
+
+/* Cumulative statistics of the batches read from the tun device */
+struct tun_batch_stats {
+  unsigned long batches;  /* Wakeups that read at least one packet */
+  unsigned long packets;  /* Packets read */
+  unsigned long full;     /* Batches that hit TUN_BATCH_SIZE */
+  unsigned max;           /* Largest batch */
+};
+
+/**
+ * \brief Prepares a tun file descriptor for batched input
+ * \param fd The tun file descriptor
+ */
+void tun_batch_init(int fd);
+
+/**
+ * \brief Reads packets from a tun device and passes each to tcpip_input()
+ * \param fd The tun file descriptor, reported readable by the main loop
+ * \param max The maximum number of packets to read, at most TUN_BATCH_SIZE
+ * \param has_room Called before each packet but the first; the batch ends
+ *        when it returns 0. NULL when the output of a packet is never queued.
+ * \return The number of packets read
+ *
+ * Packets are read directly into uip_buf, one at a time, so that no
+ * extra copy is needed before they are processed.
+ */
+int tun_batch_input(int fd, int max, int (*has_room)(void));
+
+/**
+ * \brief Returns the statistics of the batches read so far
+ */
+const struct tun_batch_stats *tun_batch_get_stats(void);
+
+#endif /* TUN_BATCH_H_ */
@@ -63,6 +63,7 @@
 #include <err.h>
 #include "net/netstack.h"
 #include "net/packetbuf.h"
+#include "tun-batch.h"
 
 static const char *config_ipaddr = "fd00::1/64";
 /* Allocate some bytes in RAM and copy the string */
@@ -217,6 +218,8 @@ tun_init()
 
   LOG_INFO("Tun open:%d\n", tunfd);
 
+  tun_batch_init(tunfd);
+
   select_set_callback(tunfd, &tun_select_callback);
 
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
@@ -240,23 +243,6 @@ tun_output(uint8_t *data, int len)
   }
   return 0;
 }
-/*---------------------------------------------------------------------------*/
-static int
-tun_input(unsigned char *data, int maxlen)
-{
-  int size;
-
-  if(tunfd == -1) {
-    /* tun is not open */
-    return 0;
-  }
-
-  if((size = read(tunfd, data, maxlen)) == -1) {
-    err(1, "tun_input: read");
-  }
-  return size;
-}
-
 /*---------------------------------------------------------------------------*/
 static uint8_t
 output(const linkaddr_t *localdest)
@@ -297,10 +283,8 @@ handle_fd(fd_set *rset, fd_set *wset)
   LOG_INFO("Tun6-handle FD\n");
 
   if(FD_ISSET(tunfd, rset)) {
-    size = tun_input(&uip_buf[UIP_LLH_LEN], sizeof(uip_buf));
-    LOG_DBG("TUN data incoming read:%d\n", size);
-    uip_len = size;
-    tcpip_input();
+    size = tun_batch_input(tunfd, TUN_BATCH_SIZE, NULL);
+    LOG_DBG("TUN data incoming read:%d packets\n", size);
   }
 }
 #endif /*  __CYGWIN_ */
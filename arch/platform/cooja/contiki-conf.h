@@ -54,6 +54,11 @@
 #define EEPROM_CONF_SIZE				1024
 #endif
 
+/* There is no AES hardware, use the faster software driver */
+#ifndef AES_128_CONF
+#define AES_128_CONF aes_128_ttable_driver
+#endif
+
 #define w_memcpy memcpy
 
 #ifdef NETSTACK_CONF_H
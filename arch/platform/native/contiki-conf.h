@@ -60,6 +60,20 @@ int select_set_callback(int fd, const struct select_callback *callback);
 #define EEPROM_CONF_SIZE				1024
 #endif
 
+/* Flash is plentiful, use the fastest CRC16 */
+#ifndef CRC16_CONF_TABLE_SLICES
+#define CRC16_CONF_TABLE_SLICES 8
+#endif
+
+/* Sum the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_CHKSUM_WIDE
+#define UIP_CONF_CHKSUM_WIDE 1
+#endif
+
+#ifndef AES_128_CONF
+#define AES_128_CONF aes_128_ttable_driver
+#endif
+
 typedef unsigned int uip_stats_t;
 
 #ifndef UIP_CONF_BYTE_ORDER
@@ -108,9 +108,42 @@
 #else
 #define SELECT_STDIN 1
 #endif
+
+/*
+ * Uses epoll (Linux only) instead of select to wait for the monitored file
+ * descriptors. File descriptors are registered with epoll once, and only
+ * updated when their callback changes the events it waits for. The wait
+ * lasts until the next etimer expiration instead of SELECT_TIMEOUT.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
+/*
+ * Defines the maximum time (in msec) the epoll main loop waits when no
+ * etimer is pending.
+ */
+#ifdef SELECT_CONF_EPOLL_MAX_TIMEOUT
+#define SELECT_EPOLL_MAX_TIMEOUT SELECT_CONF_EPOLL_MAX_TIMEOUT
+#else
+#define SELECT_EPOLL_MAX_TIMEOUT 1000
+#endif
 /** @} */
 /*---------------------------------------------------------------------------*/
 
+#if SELECT_EPOLL
+#include <sys/epoll.h>
+
+static int epoll_fd = -1;
+/* Events each file descriptor is currently registered for */
+static uint32_t epoll_events[SELECT_MAX];
+/* File descriptors that epoll does not support (e.g. regular files), and
+   that are always considered ready, as select would do */
+static uint8_t epoll_always_ready[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
@@ -133,6 +166,23 @@ select_set_callback(int fd, const struct select_callback *callback)
     }
 
     select_callback[fd] = callback;
+#if SELECT_EPOLL
+    /* The fd may be a new file with the number of a closed one, which
+       the kernel has dropped from the epoll set. Drop any registration
+       left, so that the fd is added again with its events of interest */
+    if(epoll_events[fd] != 0) {
+      struct epoll_event ev;
+
+      memset(&ev, 0, sizeof(ev));
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &ev) < 0 &&
+         errno != EBADF && errno != ENOENT) {
+        perror("epoll_ctl");
+      }
+      epoll_events[fd] = 0;
+    }
+    /* Find out again whether epoll supports this fd */
+    epoll_always_ready[fd] = 0;
+#endif /* SELECT_EPOLL */
 
     /* Update fd max */
     if(callback != NULL) {
@@ -275,12 +325,148 @@ platform_init_stage_three()
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 }
 /*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+/* Registers, updates or unregisters a file descriptor with epoll, only
+   calling into the kernel when the events of interest change */
+static void
+epoll_update(int fd, uint32_t events)
+{
+  struct epoll_event ev;
+  int op;
+
+  if(events == epoll_events[fd] || epoll_always_ready[fd]) {
+    return;
+  }
+
+  if(events == 0) {
+    op = EPOLL_CTL_DEL;
+  } else if(epoll_events[fd] == 0) {
+    op = EPOLL_CTL_ADD;
+  } else {
+    op = EPOLL_CTL_MOD;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.fd = fd;
+  if(epoll_ctl(epoll_fd, op, fd, &ev) < 0 &&
+     /* The fd may have been replaced without select_set_callback() */
+     !(op == EPOLL_CTL_MOD && errno == ENOENT &&
+       epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) &&
+     !(op == EPOLL_CTL_ADD && errno == EEXIST &&
+       epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0)) {
+    if(errno == EPERM) {
+      epoll_always_ready[fd] = 1;
+    } else if(op != EPOLL_CTL_DEL) {
+      perror("epoll_ctl");
+    }
+    events = 0;
+  }
+  epoll_events[fd] = events;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns how long (in msec) to wait for file descriptors */
+static int
+epoll_timeout(void)
+{
+  long ticks;
+
+  if(!etimer_pending()) {
+    return SELECT_EPOLL_MAX_TIMEOUT;
+  }
+  ticks = (long)(etimer_next_expiration_time() - clock_time());
+  if(ticks <= 0) {
+    return 0;
+  }
+  if(ticks >= (long)SELECT_EPOLL_MAX_TIMEOUT * CLOCK_SECOND / 1000) {
+    return SELECT_EPOLL_MAX_TIMEOUT;
+  }
+  /* Round up, so that we do not wake up just before the expiration */
+  return (ticks * 1000 + CLOCK_SECOND - 1) / CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_main_loop(void)
+{
+  struct epoll_event events[SELECT_MAX];
+  fd_set fdr;
+  fd_set fdw;
+  int always_ready;
+  int maxfd;
+  int fd;
+  int i;
+  int retval;
+
+  epoll_fd = epoll_create1(0);
+  if(epoll_fd < 0) {
+    perror("epoll_create1");
+    return;
+  }
+
+  while(1) {
+    retval = process_run();
+
+    /* Let the callbacks tell what they are waiting for */
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    maxfd = 0;
+    for(i = 0; i <= select_max; i++) {
+      if(select_callback[i] != NULL && select_callback[i]->set_fd(&fdr, &fdw)) {
+        maxfd = i;
+      }
+    }
+    always_ready = 0;
+    for(fd = 0; fd < SELECT_MAX; fd++) {
+      epoll_update(fd, (FD_ISSET(fd, &fdr) ? EPOLLIN : 0) |
+                   (FD_ISSET(fd, &fdw) ? EPOLLOUT : 0));
+      if(epoll_always_ready[fd] && (FD_ISSET(fd, &fdr) || FD_ISSET(fd, &fdw))) {
+        always_ready = 1;
+      }
+    }
+
+    retval = epoll_wait(epoll_fd, events, SELECT_MAX,
+                        retval || always_ready ? 0 : epoll_timeout());
+    if(retval < 0) {
+      if(errno != EINTR) {
+        perror("epoll_wait");
+      }
+    } else if(retval > 0 || always_ready) {
+      /* Only keep the ready file descriptors in the sets */
+      for(fd = 0; fd < SELECT_MAX; fd++) {
+        if(!epoll_always_ready[fd]) {
+          FD_CLR(fd, &fdr);
+          FD_CLR(fd, &fdw);
+        }
+      }
+      for(i = 0; i < retval; i++) {
+        if(events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+          FD_SET(events[i].data.fd, &fdr);
+        }
+        if(events[i].events & (EPOLLOUT | EPOLLERR)) {
+          FD_SET(events[i].data.fd, &fdw);
+        }
+      }
+      for(i = 0; i <= maxfd; i++) {
+        if(select_callback[i] != NULL) {
+          select_callback[i]->handle_fd(&fdr, &fdw);
+        }
+      }
+    }
+
+    etimer_request_poll();
+  }
+}
+#endif /* SELECT_EPOLL */
+/*---------------------------------------------------------------------------*/
 void
 platform_main_loop()
 {
 #if SELECT_STDIN
   select_set_callback(STDIN_FILENO, &stdin_fd);
 #endif /* SELECT_STDIN */
+#if SELECT_EPOLL
+  epoll_main_loop();
+#else /* SELECT_EPOLL */
   while(1) {
     fd_set fdr;
     fd_set fdw;
@@ -319,6 +505,7 @@ platform_main_loop()
 
     etimer_request_poll();
   }
+#endif /* SELECT_EPOLL */
 
   return;
 }
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the forwarding of 6LoWPAN fragments. The node
+ *         forwards 1200-byte UDP datagrams from a neighbor to a
+ *         destination that it routes through another neighbor, and
+ *         reports how soon the first fragment is forwarded. The
+ *         forwarded fragments are then reassembled, to check that the
+ *         datagrams are forwarded intact.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/simple-udp.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_ROUNDS         2000
+#define NUM_CHECKED_ROUNDS 100
+#define PAYLOAD_LEN        1200
+#define UDP_PORT           0xf0b0
+#define MAX_FRAMES         32
+
+#define UIP_IP_BUF ((struct uip_udpip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+PROCESS(fragment_forwarding_process, "6LoWPAN fragment forwarding");
+AUTOSTART_PROCESSES(&fragment_forwarding_process);
+
+struct frame {
+  uint8_t len;
+  uint8_t data[PACKETBUF_SIZE];
+};
+
+/* The fragments sent by the previous hop, and forwarded to the next */
+static struct frame received[MAX_FRAMES];
+static struct frame forwarded[MAX_FRAMES];
+static struct frame *frames;
+static int num_frames;
+
+static linkaddr_t previous_hop;
+static linkaddr_t next_hop;
+static uip_ipaddr_t source_addr;
+static uip_ipaddr_t destination_addr;
+
+static struct simple_udp_connection connection;
+static uint16_t round_number;
+static unsigned long delivered;
+static unsigned long mismatches;
+/*---------------------------------------------------------------------------*/
+/* A MAC layer that captures the frames instead of sending them. */
+static void
+loopback_send(mac_callback_t sent, void *ptr)
+{
+  struct frame *f;
+
+  if(num_frames == MAX_FRAMES) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
+    return;
+  }
+  f = &frames[num_frames++];
+  f->len = packetbuf_datalen();
+  memcpy(f->data, packetbuf_dataptr(), f->len);
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver loopback_mac_driver = {
+  "loopback",
+  loopback_init,
+  loopback_send,
+  loopback_input,
+  loopback_on,
+  loopback_off,
+};
+/*---------------------------------------------------------------------------*/
+static uint8_t
+payload_byte(uint16_t round, uint16_t i)
+{
+  return (uint8_t)(round * 13 + i * 7 + (i >> 8));
+}
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  uint16_t i;
+
+  delivered++;
+  if(datalen != PAYLOAD_LEN ||
+     !uip_ipaddr_cmp(sender_addr, &source_addr)) {
+    mismatches++;
+    return;
+  }
+  for(i = 0; i < datalen; i++) {
+    if(data[i] != payload_byte(round_number, i)) {
+      mismatches++;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Fragment a UDP datagram as the previous hop would send it to this
+   node, whose link-layer address it temporarily takes. */
+static void
+send_datagram(void)
+{
+  uip_lladdr_t lladdr;
+  uint8_t *payload;
+  uint16_t i;
+
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcf = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->len[0] = (uip_len - UIP_IPH_LEN) >> 8;
+  UIP_IP_BUF->len[1] = (uip_len - UIP_IPH_LEN) & 0xff;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &source_addr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &destination_addr);
+  UIP_IP_BUF->srcport = UIP_HTONS(UDP_PORT + 1);
+  UIP_IP_BUF->destport = UIP_HTONS(UDP_PORT);
+  UIP_IP_BUF->udplen = UIP_HTONS(uip_len - UIP_IPH_LEN);
+  UIP_IP_BUF->udpchksum = 0;
+  payload = &uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_UDPH_LEN];
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = payload_byte(round_number, i);
+  }
+  UIP_IP_BUF->udpchksum = ~(uip_udpchksum());
+  if(UIP_IP_BUF->udpchksum == 0) {
+    UIP_IP_BUF->udpchksum = 0xffff;
+  }
+
+  memcpy(&lladdr, &uip_lladdr, sizeof(lladdr));
+  memcpy(&uip_lladdr, &previous_hop, sizeof(uip_lladdr));
+  frames = received;
+  num_frames = 0;
+  NETSTACK_NETWORK.output(&linkaddr_node_addr);
+  memcpy(&uip_lladdr, &lladdr, sizeof(uip_lladdr));
+  uip_clear_buf();
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive_frame(const struct frame *f, const linkaddr_t *sender,
+              const linkaddr_t *receiver)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(f->data, f->len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, receiver);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Receive the fragments of a datagram from the previous hop, and
+   return the number of fragments received before the first one was
+   forwarded. */
+static int
+forward_datagram(int num_received)
+{
+  int first = 0;
+  int i;
+
+  frames = forwarded;
+  num_frames = 0;
+  for(i = 0; i < num_received; i++) {
+    receive_frame(&received[i], &previous_hop, &linkaddr_node_addr);
+    if(first == 0 && num_frames > 0) {
+      first = i + 1;
+    }
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(fragment_forwarding_process, ev, data)
+{
+  static clock_time_t start;
+  static unsigned long num_forwarded;
+  static int first_forwarded;
+  static int num_received;
+  uip_ipaddr_t next_hop_addr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Fragment forwarding: %d\n", SICSLOWPAN_CONF_FRAG_FORWARDING);
+
+  /* The previous hop, the next hop, and a destination behind it */
+  memset(&previous_hop, 0, sizeof(previous_hop));
+  previous_hop.u8[0] = 0x02;
+  previous_hop.u8[LINKADDR_SIZE - 1] = 1;
+  memset(&next_hop, 0, sizeof(next_hop));
+  next_hop.u8[0] = 0x02;
+  next_hop.u8[LINKADDR_SIZE - 1] = 2;
+  uip_ip6addr(&source_addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&source_addr, (uip_lladdr_t *)&previous_hop);
+  uip_ip6addr(&destination_addr, 0xfd00, 0, 0, 0, 0x200, 0, 0, 9);
+  uip_create_linklocal_prefix(&next_hop_addr);
+  uip_ds6_set_addr_iid(&next_hop_addr, (uip_lladdr_t *)&next_hop);
+  uip_ds6_nbr_add(&next_hop_addr, (uip_lladdr_t *)&next_hop, 1,
+                  NBR_REACHABLE, NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_ds6_route_add(&destination_addr, 128, &next_hop_addr);
+
+  simple_udp_register(&connection, UDP_PORT, NULL, UDP_PORT + 1, receiver);
+
+  num_forwarded = 0;
+  first_forwarded = 0;
+  start = clock_time();
+  for(round_number = 0; round_number < NUM_ROUNDS; round_number++) {
+    send_datagram();
+    num_received = num_frames;
+    first_forwarded = forward_datagram(num_received);
+    num_forwarded += num_frames;
+  }
+  printf("%u datagrams of %u bytes forwarded: %lu ticks (%lu ticks/s)\n",
+         NUM_ROUNDS, PAYLOAD_LEN, (unsigned long)(clock_time() - start),
+         (unsigned long)CLOCK_SECOND);
+  printf("Forwarded fragments: %lu of %lu\n",
+         num_forwarded, (unsigned long)num_received * NUM_ROUNDS);
+  printf("First fragment forwarded after %d of %d received fragments\n",
+         first_forwarded, num_received);
+
+  /* Reassemble the forwarded fragments, as the destination */
+  delivered = 0;
+  mismatches = 0;
+  for(round_number = 0; round_number < NUM_CHECKED_ROUNDS; round_number++) {
+    send_datagram();
+    forward_datagram(num_frames);
+    uip_ds6_addr_add(&destination_addr, 0, ADDR_MANUAL);
+    for(i = 0; i < num_frames; i++) {
+      receive_frame(&forwarded[i], &linkaddr_node_addr, &next_hop);
+    }
+    uip_ds6_addr_rm(uip_ds6_addr_lookup(&destination_addr));
+  }
+  printf("Delivered datagrams: %lu of %u\n", delivered, NUM_CHECKED_ROUNDS);
+  printf("Mismatching datagrams: %lu\n", mismatches);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
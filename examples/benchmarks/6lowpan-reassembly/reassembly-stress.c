@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Stress test for 6LoWPAN fragment reassembly. Three senders
+ *         send 1280-byte UDP payloads at the same time, and their
+ *         fragments are received in random order, with some of them
+ *         duplicated. Checks that every datagram is delivered intact.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/simple-udp.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_SENDERS         3
+#define NUM_ROUNDS          2000
+#define NUM_SHUFFLED_ROUNDS 100
+#define PAYLOAD_LEN         1280
+#define UDP_PORT            0xf0b0
+#define MAX_FRAMES          (NUM_SENDERS * 32)
+#define DUPLICATE_ONE_IN    10
+
+#define UIP_IP_BUF ((struct uip_udpip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+PROCESS(reassembly_stress_process, "6LoWPAN reassembly stress test");
+AUTOSTART_PROCESSES(&reassembly_stress_process);
+
+struct frame {
+  uint8_t sender;
+  uint8_t len;
+  uint8_t data[PACKETBUF_SIZE];
+};
+
+static struct frame frames[MAX_FRAMES];
+static struct frame *shuffled[MAX_FRAMES];
+static struct frame *order[MAX_FRAMES * 2];
+static int num_frames;
+static uint8_t current_sender;
+
+static struct simple_udp_connection connection;
+static uint16_t round_number;
+static unsigned long delivered;
+static unsigned long mismatches;
+/*---------------------------------------------------------------------------*/
+/* A MAC layer that captures the frames instead of sending them. */
+static void
+loopback_send(mac_callback_t sent, void *ptr)
+{
+  struct frame *f;
+
+  if(num_frames == MAX_FRAMES) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
+    return;
+  }
+  f = &frames[num_frames++];
+  f->sender = current_sender;
+  f->len = packetbuf_datalen();
+  memcpy(f->data, packetbuf_dataptr(), f->len);
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver loopback_mac_driver = {
+  "loopback",
+  loopback_init,
+  loopback_send,
+  loopback_input,
+  loopback_on,
+  loopback_off,
+};
+/*---------------------------------------------------------------------------*/
+static uint8_t
+payload_byte(uint8_t sender, uint16_t round, uint16_t i)
+{
+  return (uint8_t)(sender * 71 + round * 13 + i * 7 + (i >> 8));
+}
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  uint8_t sender;
+  uint16_t i;
+
+  delivered++;
+  sender = sender_addr->u8[15];
+  if(datalen != PAYLOAD_LEN || sender >= NUM_SENDERS) {
+    mismatches++;
+    return;
+  }
+  for(i = 0; i < datalen; i++) {
+    if(data[i] != payload_byte(sender, round_number, i)) {
+      mismatches++;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Build a UDP datagram from a sender to this node in uip_buf, and
+   fragment it. */
+static void
+send_datagram(uint8_t sender)
+{
+  uint8_t *payload;
+  uint16_t i;
+
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcf = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->len[0] = (uip_len - UIP_IPH_LEN) >> 8;
+  UIP_IP_BUF->len[1] = (uip_len - UIP_IPH_LEN) & 0xff;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0x100, sender);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->destipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->destipaddr, &uip_lladdr);
+  UIP_IP_BUF->srcport = UIP_HTONS(UDP_PORT + 1);
+  UIP_IP_BUF->destport = UIP_HTONS(UDP_PORT);
+  UIP_IP_BUF->udplen = UIP_HTONS(uip_len - UIP_IPH_LEN);
+  UIP_IP_BUF->udpchksum = 0;
+  payload = &uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_UDPH_LEN];
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = payload_byte(sender, round_number, i);
+  }
+  UIP_IP_BUF->udpchksum = ~(uip_udpchksum());
+  if(UIP_IP_BUF->udpchksum == 0) {
+    UIP_IP_BUF->udpchksum = 0xffff;
+  }
+
+  current_sender = sender;
+  NETSTACK_NETWORK.output(&linkaddr_node_addr);
+  uip_clear_buf();
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive_frame(const struct frame *f)
+{
+  linkaddr_t sender;
+
+  memset(&sender, 0, sizeof(sender));
+  sender.u8[0] = 0x02;
+  sender.u8[LINKADDR_SIZE - 1] = f->sender + 1;
+
+  packetbuf_clear();
+  packetbuf_copyfrom(f->data, f->len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Fragment a datagram from each sender, and put their fragments in
+   order, interleaved, or in random order with some duplicates. */
+static int
+send_round(int shuffle)
+{
+  struct frame *f;
+  int num_order;
+  int i, j;
+
+  num_frames = 0;
+  for(i = 0; i < NUM_SENDERS; i++) {
+    send_datagram(i);
+  }
+
+  num_order = 0;
+  if(!shuffle) {
+    for(i = 0; i < num_frames / NUM_SENDERS; i++) {
+      for(j = 0; j < NUM_SENDERS; j++) {
+        order[num_order++] = &frames[j * (num_frames / NUM_SENDERS) + i];
+      }
+    }
+    return num_order;
+  }
+
+  for(i = 0; i < num_frames; i++) {
+    shuffled[i] = &frames[i];
+  }
+  for(i = num_frames - 1; i > 0; i--) {
+    j = random_rand() % (i + 1);
+    f = shuffled[i];
+    shuffled[i] = shuffled[j];
+    shuffled[j] = f;
+  }
+  /* A duplicate comes right after its original, as when the
+     link-layer ACK of a frame is lost. */
+  for(i = 0; i < num_frames; i++) {
+    order[num_order++] = shuffled[i];
+    if(random_rand() % DUPLICATE_ONE_IN == 0) {
+      order[num_order++] = shuffled[i];
+    }
+  }
+  return num_order;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(reassembly_stress_process, ev, data)
+{
+  static struct etimer et;
+  static clock_time_t start;
+  static unsigned long expected;
+  static int phase;
+  int num_order;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Direct reassembly: %d\n", SICSLOWPAN_CONF_REASS_DIRECT);
+
+  simple_udp_register(&connection, UDP_PORT, NULL, UDP_PORT + 1, receiver);
+
+  for(phase = 0; phase < 2; phase++) {
+    delivered = 0;
+    mismatches = 0;
+    expected = 0;
+    start = clock_time();
+    for(round_number = 0;
+        round_number < (phase == 0 ? NUM_ROUNDS : NUM_SHUFFLED_ROUNDS);
+        round_number++) {
+      num_order = send_round(phase);
+      /* The frames are received after the round is sent, so that the
+         fragments of all senders use the same 6LoWPAN contexts. */
+      for(i = 0; i < num_order; i++) {
+        receive_frame(order[i]);
+      }
+      expected += NUM_SENDERS;
+      if(delivered < expected || phase == 1) {
+        /* Let the incomplete reassemblies time out, and those that a
+           late duplicate has started again. */
+        etimer_set(&et, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16 + 1);
+        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+      }
+    }
+    if(phase == 0) {
+      printf("%u rounds of %u interleaved datagrams: %lu ticks "
+             "(%lu ticks/s)\n", NUM_ROUNDS, NUM_SENDERS,
+             (unsigned long)(clock_time() - start),
+             (unsigned long)CLOCK_SECOND);
+    } else {
+      printf("%u rounds of %u datagrams in random order, "
+             "with duplicates\n", NUM_SHUFFLED_ROUNDS, NUM_SENDERS);
+    }
+    printf("Delivered datagrams: %lu of %lu\n", delivered, expected);
+    printf("Mismatching datagrams: %lu\n", mismatches);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for software AES-128. Checks the drivers against the
+ *         FIPS-197 test vector and against each other, then measures
+ *         key expansion, block encryption, and the cost of securing an
+ *         IEEE 802.15.4 frame with CCM* (MIC and encryption) through
+ *         the configured AES_128 driver.
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_BLOCKS   200000UL
+#define NUM_KEYS     20000UL
+#define NUM_FRAMES   20000UL
+
+/* A TSCH data frame with a 25-byte header, 90-byte payload and 8-byte MIC */
+#define FRAME_HDR_LEN     25
+#define FRAME_PAYLOAD_LEN 90
+#define FRAME_MIC_LEN     8
+
+PROCESS(aes_frame_process, "AES-128 benchmark");
+AUTOSTART_PROCESSES(&aes_frame_process);
+
+static const struct {
+  const char *name;
+  const struct aes_128_driver *driver;
+} drivers[] = {
+  { "aes_128_driver", &aes_128_driver },
+  { "aes_128_ttable_driver", &aes_128_ttable_driver },
+  { "aes_128_bitsliced_driver", &aes_128_bitsliced_driver },
+};
+#define NUM_DRIVERS (sizeof(drivers) / sizeof(drivers[0]))
+
+static uint8_t keys[2][AES_128_KEY_LENGTH];
+/*---------------------------------------------------------------------------*/
+static int
+check_drivers(void)
+{
+  /* FIPS-197, appendix C.1 */
+  static const uint8_t key[AES_128_KEY_LENGTH] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+  };
+  static const uint8_t plaintext[AES_128_BLOCK_SIZE] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+  };
+  static const uint8_t ciphertext[AES_128_BLOCK_SIZE] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+  };
+  uint8_t expected[AES_128_BLOCK_SIZE];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  uint8_t random_key[AES_128_KEY_LENGTH];
+  int mismatches;
+  int i, j, d;
+
+  mismatches = 0;
+  for(d = 0; d < NUM_DRIVERS; d++) {
+    memcpy(block, plaintext, sizeof(block));
+    drivers[d].driver->set_key(key);
+    drivers[d].driver->encrypt(block);
+    if(memcmp(block, ciphertext, sizeof(block))) {
+      printf("%s fails the FIPS-197 test vector\n", drivers[d].name);
+      mismatches++;
+    }
+  }
+
+  /* Random keys and blocks, cycling through more keys than are cached */
+  for(i = 0; i < 1000; i++) {
+    for(j = 0; j < AES_128_KEY_LENGTH; j++) {
+      random_key[j] = random_rand();
+    }
+    for(j = 0; j < AES_128_BLOCK_SIZE; j++) {
+      expected[j] = random_rand();
+    }
+    if(i % 7 == 0) {
+      memcpy(random_key, keys[i & 1], AES_128_KEY_LENGTH);
+    }
+    for(d = 0; d < NUM_DRIVERS; d++) {
+      drivers[d].driver->set_key(random_key);
+    }
+    memcpy(block, expected, sizeof(block));
+    aes_128_driver.encrypt(expected);
+    for(d = 1; d < NUM_DRIVERS; d++) {
+      uint8_t copy[AES_128_BLOCK_SIZE];
+
+      memcpy(copy, block, sizeof(copy));
+      drivers[d].driver->encrypt(copy);
+      if(memcmp(copy, expected, sizeof(copy))) {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_driver(const char *name, const struct aes_128_driver *driver)
+{
+  uint8_t block[AES_128_BLOCK_SIZE];
+  unsigned long key_ticks;
+  unsigned long block_ticks;
+  clock_time_t start;
+  unsigned long i;
+
+  /* Distinct keys, so that none comes from the key schedule cache */
+  start = clock_time();
+  for(i = 0; i < NUM_KEYS; i++) {
+    keys[1][0] = i;
+    keys[1][1] = i >> 8;
+    driver->set_key(keys[1]);
+  }
+  key_ticks = clock_time() - start;
+
+  memset(block, 0, sizeof(block));
+  driver->set_key(keys[0]);
+  start = clock_time();
+  for(i = 0; i < NUM_BLOCKS; i++) {
+    driver->encrypt(block);
+  }
+  block_ticks = clock_time() - start;
+
+  printf("%-26s %lu key expansions in %lu ticks, %lu blocks in %lu ticks\n",
+         name, NUM_KEYS, key_ticks, NUM_BLOCKS, block_ticks);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+bench_frames(int alternate_keys)
+{
+  uint8_t frame[FRAME_HDR_LEN + FRAME_PAYLOAD_LEN + FRAME_MIC_LEN];
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  clock_time_t start;
+  unsigned long i;
+
+  memset(frame, 0x5a, sizeof(frame));
+  memset(nonce, 0, sizeof(nonce));
+  start = clock_time();
+  for(i = 0; i < NUM_FRAMES; i++) {
+    /* As tsch_security_secure_frame() does for every frame */
+    nonce[12] = i;
+    CCM_STAR.set_key(keys[alternate_keys ? (i & 1) : 0]);
+    CCM_STAR.aead(nonce, frame + FRAME_HDR_LEN, FRAME_PAYLOAD_LEN,
+                  frame, FRAME_HDR_LEN,
+                  frame + FRAME_HDR_LEN + FRAME_PAYLOAD_LEN, FRAME_MIC_LEN, 1);
+  }
+  return clock_time() - start;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(aes_frame_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < AES_128_KEY_LENGTH; i++) {
+    keys[0][i] = random_rand();
+    keys[1][i] = random_rand();
+  }
+
+  printf("Mismatching encryptions: %d\n", check_drivers());
+
+  for(i = 0; i < NUM_DRIVERS; i++) {
+    bench_driver(drivers[i].name, drivers[i].driver);
+  }
+
+  printf("CCM* frames (%d-byte header, %d-byte payload, %d-byte MIC):\n",
+         FRAME_HDR_LEN, FRAME_PAYLOAD_LEN, FRAME_MIC_LEN);
+  printf("  same key:         %lu frames in %lu ticks\n",
+         NUM_FRAMES, bench_frames(0));
+  printf("  alternating keys: %lu frames in %lu ticks\n",
+         NUM_FRAMES, bench_frames(1));
+  printf("(%lu ticks/s, key cache size %d)\n",
+         (unsigned long)CLOCK_SECOND, AES_128_KEY_CACHE_SIZE);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
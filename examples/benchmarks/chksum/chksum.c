@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the Internet checksum of uIP. Cross-checks
+ *         uip_chksum() against the 16-bit algorithm over all lengths and
+ *         alignments, and uip_chksum_update() against full computations.
+ *         Then times the UDP checksum of datagrams of several sizes, and
+ *         the reply to echo requests.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_LEN       300
+#define NUM_UPDATES   10000
+#define DATA_BYTES    (64UL * 1024 * 1024)
+#define NUM_ECHOES    200000
+#define ECHO_LEN      1232
+
+#define UIP_IP_BUF    ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_UDP_BUF   ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+#define UIP_ICMP_BUF  ((struct uip_icmp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+
+PROCESS(chksum_process, "Checksum benchmark");
+AUTOSTART_PROCESSES(&chksum_process);
+
+static uint8_t buf[MAX_LEN + 8];
+static uint8_t echo_request[UIP_IPH_LEN + ECHO_LEN];
+static const uint16_t sizes[] = { 64, 256, 1232 };
+/*---------------------------------------------------------------------------*/
+/* The 16-bit algorithm, byte by byte */
+static uint16_t
+reference_chksum(const uint8_t *data, uint16_t len)
+{
+  uint32_t sum = 0;
+  uint16_t i;
+
+  for(i = 0; i + 1 < len; i += 2) {
+    sum += (data[i] << 8) + data[i + 1];
+  }
+  if(len & 1) {
+    sum += data[len - 1] << 8;
+  }
+  while(sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+check_chksum(void)
+{
+  unsigned long mismatches = 0;
+  uint16_t len;
+  int align;
+
+  for(len = 0; len < sizeof(buf); len++) {
+    buf[len] = random_rand();
+  }
+  for(align = 0; align < 8; align++) {
+    for(len = 0; len <= MAX_LEN; len++) {
+      if(uip_chksum((uint16_t *)(buf + align), len)
+         != reference_chksum(buf + align, len)) {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+/*---------------------------------------------------------------------------*/
+/* 0x0000 and 0xffff are the two representations of zero */
+static int
+chksum_equal(uint16_t a, uint16_t b)
+{
+  return a == b || (a == 0xffff && b == 0) || (a == 0 && b == 0xffff);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+check_update(void)
+{
+  unsigned long mismatches = 0;
+  uint8_t old_data[16];
+  uint16_t chksum;
+  uint16_t offset;
+  uint16_t len;
+  uint16_t i;
+  int n;
+
+  for(n = 0; n < NUM_UPDATES; n++) {
+    for(i = 0; i < 64; i++) {
+      buf[i] = random_rand();
+    }
+    chksum = ~uip_chksum((uint16_t *)buf, 64);
+    len = (random_rand() % 8 + 1) * 2;
+    offset = (random_rand() % ((64 - len) / 2 + 1)) * 2;
+    memcpy(old_data, buf + offset, len);
+    for(i = 0; i < len; i++) {
+      buf[offset + i] = random_rand();
+    }
+    chksum = uip_chksum_update(chksum, old_data, buf + offset, len);
+    if(!chksum_equal(chksum, (uint16_t)~uip_chksum((uint16_t *)buf, 64))) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_udp(uint16_t payload_len)
+{
+  uint16_t i;
+
+  memset(UIP_IP_BUF, 0, UIP_IPH_LEN + UIP_UDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[0] = (UIP_UDPH_LEN + payload_len) >> 8;
+  UIP_IP_BUF->len[1] = (UIP_UDPH_LEN + payload_len) & 0xff;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0x0212, 0x7401, 1, 1);
+  uip_ip6addr(&UIP_IP_BUF->destipaddr, 0xfd00, 0, 0, 0, 0x0212, 0x7402, 2, 2);
+  UIP_UDP_BUF->srcport = UIP_HTONS(5678);
+  UIP_UDP_BUF->destport = UIP_HTONS(8765);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + payload_len);
+  for(i = 0; i < payload_len; i++) {
+    uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_UDPH_LEN + i] = i * 7 + 3;
+  }
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + payload_len;
+  uip_ext_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_echo_request(void)
+{
+  fill_udp(ECHO_LEN - UIP_ICMPH_LEN - UIP_UDPH_LEN);
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_ICMP_BUF->type = ICMP6_ECHO_REQUEST;
+  UIP_ICMP_BUF->icode = 0;
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_time(const char *what, clock_time_t ticks, unsigned long n,
+           unsigned long bytes)
+{
+  if(ticks == 0) {
+    ticks = 1;
+  }
+  printf("%s: %lu ns each, %lu MB/s\n", what,
+         (unsigned long)((unsigned long long)ticks * 1000000000 /
+                         CLOCK_SECOND / n),
+         (unsigned long)((unsigned long long)bytes * CLOCK_SECOND /
+                         ticks / 1000000));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(chksum_process, ev, data)
+{
+  static clock_time_t start;
+  static uint16_t sum;
+  static unsigned long n;
+  static unsigned long count;
+  static int i;
+  char what[32];
+
+  PROCESS_BEGIN();
+
+  printf("Wide checksum: %d\n", UIP_CHKSUM_WIDE);
+  printf("Mismatching checksums: %lu\n", check_chksum());
+  printf("Mismatching updates: %lu\n", check_update());
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    fill_udp(sizes[i]);
+    count = DATA_BYTES / sizes[i];
+    start = clock_time();
+    for(n = 0; n < count; n++) {
+      sum += uip_udpchksum();
+    }
+    snprintf(what, sizeof(what), "UDP checksum, %u bytes", sizes[i]);
+    print_time(what, clock_time() - start, count, count * sizes[i]);
+    printf("Checksum of the datagram: 0x%04x\n", uip_udpchksum());
+  }
+
+  fill_echo_request();
+  memcpy(echo_request, UIP_IP_BUF, sizeof(echo_request));
+
+  start = clock_time();
+  for(n = 0; n < NUM_ECHOES; n++) {
+    memcpy(UIP_IP_BUF, echo_request, sizeof(echo_request));
+    uip_len = sizeof(echo_request);
+    uip_ext_len = 0;
+    uip_icmp6_input(ICMP6_ECHO_REQUEST, 0);
+  }
+  print_time("Echo reply, 1232 bytes", clock_time() - start,
+             NUM_ECHOES, NUM_ECHOES * ECHO_LEN);
+  printf("Bad echo replies: %d\n",
+         UIP_ICMP_BUF->type != ICMP6_ECHO_REPLY || uip_icmp6chksum() != 0xffff);
+  uip_clear_buf();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the dispatching of CoAP requests to resources.
+ *         Activates resources laid out like the objects of an IPSO
+ *         node, and looks up a mix of URI paths: resources, their
+ *         sub-resources, and paths that match no resource.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_OBJECTS     6
+#define NUM_INSTANCES   4
+#define NUM_RESOURCES   (NUM_OBJECTS * NUM_INSTANCES * 2 + 4)
+#define NUM_LOOKUPS     1000000UL
+#define URL_LEN         24
+#define PATH_LEN        (URL_LEN + 8)
+
+PROCESS(coap_dispatch_process, "CoAP dispatch benchmark");
+AUTOSTART_PROCESSES(&coap_dispatch_process);
+
+static const char *const objects[NUM_OBJECTS] = {
+  "3303", "3304", "3311", "3315", "3323", "3342"
+};
+
+static coap_resource_t resources[NUM_RESOURCES];
+static char urls[NUM_RESOURCES][URL_LEN];
+static int num_resources;
+
+/* URI paths of requests: those of all resources, plus sub-resources
+   and unknown paths. */
+static char paths[NUM_RESOURCES * 3][PATH_LEN];
+static int num_paths;
+/*---------------------------------------------------------------------------*/
+static void
+add_resource(const char *url, coap_resource_flags_t flags)
+{
+  coap_resource_t *resource;
+
+  resource = &resources[num_resources];
+  strncpy(urls[num_resources], url, URL_LEN - 1);
+  resource->flags = flags;
+  resource->attributes = "";
+  coap_activate_resource(resource, urls[num_resources]);
+  num_resources++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_path(const char *path)
+{
+  strncpy(paths[num_paths++], path, PATH_LEN - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* The matching of the CoAP engine without an index: the first resource
+   in the list whose URL is the path, or a prefix of it followed by a
+   slash for resources with sub-resources. */
+static coap_resource_t *
+find_in_list(const char *url, int url_len)
+{
+  coap_resource_t *resource;
+  int res_url_len;
+
+  for(resource = coap_get_first_resource(); resource != NULL;
+      resource = coap_get_next_resource(resource)) {
+    res_url_len = strlen(resource->url);
+    if((url_len == res_url_len
+        || (url_len > res_url_len
+            && (resource->flags & HAS_SUB_RESOURCES)
+            && url[res_url_len] == '/'))
+       && strncmp(resource->url, url, res_url_len) == 0) {
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+setup(void)
+{
+  char url[PATH_LEN];
+  int i, j;
+
+  /* The device object, which handles its resources itself, activated
+     before a resource that it shadows. */
+  add_resource("3/0", HAS_SUB_RESOURCES);
+  add_resource("3/0/13", 0);
+  add_resource("sensors", HAS_SUB_RESOURCES);
+  add_resource("actuators/toggle", 0);
+
+  for(i = 0; i < NUM_OBJECTS; i++) {
+    for(j = 0; j < NUM_INSTANCES; j++) {
+      snprintf(url, sizeof(url), "%s/%d/5700", objects[i], j);
+      add_resource(url, IS_OBSERVABLE);
+      snprintf(url, sizeof(url), "%s/%d", objects[i], j);
+      add_resource(url, HAS_SUB_RESOURCES);
+    }
+  }
+
+  /* Activating a resource again moves it to the end of the list. */
+  coap_activate_resource(&resources[2], urls[2]);
+
+  for(i = 0; i < num_resources; i++) {
+    add_path(urls[i]);
+    snprintf(url, sizeof(url), "%s/5601", urls[i]);
+    add_path(url);
+    snprintf(url, sizeof(url), "%sx", urls[i]);
+    add_path(url);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_dispatch_process, ev, data)
+{
+  static coap_resource_t *found;
+  clock_time_t start;
+  unsigned long lookups;
+  unsigned long hits;
+  unsigned long mismatches;
+  const char *path;
+  int i;
+
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  setup();
+
+  printf("Resource hash size: %d\n", COAP_RESOURCE_HASH_SIZE);
+  printf("%d resources, %d request paths\n", num_resources + 1, num_paths);
+
+  mismatches = 0;
+  for(i = 0; i < num_paths; i++) {
+    if(coap_find_resource(paths[i], strlen(paths[i])) !=
+       find_in_list(paths[i], strlen(paths[i]))) {
+      mismatches++;
+    }
+  }
+  printf("Mismatching lookups: %lu\n", mismatches);
+
+  hits = 0;
+  start = clock_time();
+  for(lookups = 0; lookups < NUM_LOOKUPS; lookups++) {
+    path = paths[random_rand() % num_paths];
+    found = coap_find_resource(path, strlen(path));
+    hits += found != NULL;
+  }
+  printf("%lu lookups (%lu hits): %lu ticks (%lu ticks/s)\n",
+         NUM_LOOKUPS, hits, (unsigned long)(clock_time() - start),
+         (unsigned long)CLOCK_SECOND);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
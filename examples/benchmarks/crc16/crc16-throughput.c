@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Throughput benchmark for crc16_data(). Cross-checks it against
+ *         the bit-serial algorithm used without CRC16_TABLE_SLICES over
+ *         all lengths and alignments, then times both on frame-sized
+ *         and MTU-sized buffers.
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define MAX_LEN        1280
+#define CHECK_LEN      300
+#define BENCH_BYTES    (16UL * 1024 * 1024)
+
+PROCESS(crc16_throughput_process, "CRC16 benchmark");
+AUTOSTART_PROCESSES(&crc16_throughput_process);
+
+static unsigned char buf[MAX_LEN + 8];
+/*---------------------------------------------------------------------------*/
+static unsigned short
+bitwise_data(const unsigned char *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc ^= data[i];
+    acc  = (acc >> 8) | (acc << 8);
+    acc ^= (acc & 0xff00) << 4;
+    acc ^= (acc >> 8) >> 4;
+    acc ^= (acc & 0xff00) >> 5;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+run(unsigned short (*crc)(const unsigned char *, int, unsigned short),
+    int len)
+{
+  unsigned long i;
+  unsigned short acc;
+  clock_time_t start;
+
+  acc = 0;
+  start = clock_time();
+  for(i = 0; i < BENCH_BYTES / len; i++) {
+    acc = crc(buf, len, acc);
+  }
+  /* Keep the result alive */
+  buf[0] ^= acc & 1;
+  return (unsigned long)(clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crc16_throughput_process, ev, data)
+{
+  static const int lens[] = { 8, 127, MAX_LEN };
+  unsigned short acc;
+  int mismatches;
+  int offset;
+  int len;
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+
+  printf("CRC16 table slices: %d\n", CRC16_TABLE_SLICES);
+  printf("Check value: 0x%04x (expected 0x2189)\n",
+         crc16_data((const unsigned char *)"123456789", 9, 0));
+
+  mismatches = 0;
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len <= CHECK_LEN; len++) {
+      acc = random_rand();
+      if(crc16_data(buf + offset, len, acc) !=
+         bitwise_data(buf + offset, len, acc)) {
+        mismatches++;
+      }
+    }
+  }
+  for(i = 0; i < CHECK_LEN; i++) {
+    acc = random_rand();
+    if(crc16_add(buf[i], acc) != bitwise_data(&buf[i], 1, acc)) {
+      mismatches++;
+    }
+  }
+  printf("Mismatching checksums: %d\n", mismatches);
+
+  for(i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+    printf("%4d-byte buffers: bit-serial %lu ticks, crc16_data %lu ticks "
+           "for %lu bytes (%lu ticks/s)\n", lens[i],
+           run(bitwise_data, lens[i]), run(crc16_data, lens[i]),
+           BENCH_BYTES, (unsigned long)CLOCK_SECOND);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Stress benchmark for heapmem. Mimics the allocations of a
+ *         CoAP/LwM2M server: many short-lived small objects (options,
+ *         URI paths, TLV values), some medium ones living for a few
+ *         requests (transactions, observers), and a few large block
+ *         buffers. Objects are filled with a pattern that is checked
+ *         when they are freed.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_SLOTS     256
+#define NUM_OPS       2000000UL
+
+PROCESS(heapmem_stress_process, "heapmem benchmark");
+AUTOSTART_PROCESSES(&heapmem_stress_process);
+
+static struct {
+  uint8_t *ptr;
+  uint16_t size;
+} slots[NUM_SLOTS];
+
+static unsigned long failures;
+static unsigned long corruptions;
+static size_t max_footprint;
+/*---------------------------------------------------------------------------*/
+static uint16_t
+random_size(void)
+{
+  unsigned r;
+
+  r = random_rand() % 100;
+  if(r < 70) {
+    /* Option values, URI segments, TLV values */
+    return 4 + random_rand() % 45;
+  } else if(r < 95) {
+    /* Transactions, observers, resource instances */
+    return 64 + random_rand() % 65;
+  } else {
+    /* Block-wise transfer buffers */
+    return 256 + random_rand() % 769;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+release(int i)
+{
+  uint16_t j;
+
+  if(slots[i].ptr != NULL) {
+    for(j = 0; j < slots[i].size; j++) {
+      if(slots[i].ptr[j] != (uint8_t)(i + j)) {
+        corruptions++;
+        break;
+      }
+    }
+    heapmem_free(slots[i].ptr);
+    slots[i].ptr = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(int i, uint16_t from)
+{
+  uint16_t j;
+
+  for(j = from; j < slots[i].size; j++) {
+    slots[i].ptr[j] = i + j;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stress(void)
+{
+  heapmem_stats_t stats;
+  unsigned long op;
+  uint8_t *ptr;
+  uint16_t size;
+  int i;
+
+  for(op = 0; op < NUM_OPS; op++) {
+    /* Small objects are short-lived: they use the lower slots, which
+       are reused more often. */
+    i = random_rand() % 4 == 0 ? random_rand() % NUM_SLOTS
+                               : random_rand() % (NUM_SLOTS / 4);
+    if(slots[i].ptr == NULL) {
+      size = random_size();
+      slots[i].ptr = heapmem_alloc(size);
+      if(slots[i].ptr == NULL) {
+        failures++;
+        continue;
+      }
+      slots[i].size = size;
+      fill(i, 0);
+    } else if(random_rand() % 8 == 0) {
+      /* Grow an object, e.g. a payload being assembled */
+      size = slots[i].size + random_rand() % 64;
+      ptr = heapmem_realloc(slots[i].ptr, size);
+      if(ptr == NULL) {
+        failures++;
+        continue;
+      }
+      slots[i].ptr = ptr;
+      slots[i].size = size;
+      fill(i, 0);
+    } else {
+      release(i);
+    }
+
+    if(op % 1024 == 0) {
+      heapmem_stats(&stats);
+      if(stats.footprint > max_footprint) {
+        max_footprint = stats.footprint;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heapmem_stress_process, ev, data)
+{
+  heapmem_stats_t stats;
+  clock_time_t start;
+  unsigned long ticks;
+  int i;
+
+  PROCESS_BEGIN();
+
+  start = clock_time();
+  stress();
+  ticks = clock_time() - start;
+
+  heapmem_stats(&stats);
+  printf("Size classes: %d\n", HEAPMEM_SIZE_CLASSES);
+  printf("%lu operations in %lu ticks (%lu ticks/s)\n",
+         NUM_OPS, ticks, (unsigned long)CLOCK_SECOND);
+  printf("Failed allocations: %lu\n", failures);
+  printf("Corrupted objects: %lu\n", corruptions);
+  printf("Allocated %u, available %u, overhead %u, footprint %u "
+         "(max %u of %u), chunks %u\n",
+         (unsigned)stats.allocated, (unsigned)stats.available,
+         (unsigned)stats.overhead, (unsigned)stats.footprint,
+         (unsigned)max_footprint, HEAPMEM_CONF_ARENA_SIZE,
+         (unsigned)stats.chunks);
+#if HEAPMEM_SIZE_CLASSES
+  for(i = 0; i < HEAPMEM_SIZE_CLASSES; i++) {
+    printf("  class %3u bytes: %u allocated, %u free\n",
+           (unsigned)stats.classes[i].size,
+           (unsigned)stats.classes[i].allocated,
+           (unsigned)stats.classes[i].free);
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+  for(i = 0; i < NUM_SLOTS; i++) {
+    release(i);
+  }
+  heapmem_stats(&stats);
+  printf("After freeing everything: allocated %u, corrupted %lu\n",
+         (unsigned)stats.allocated, corruptions);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for IPHC header compression and uncompression,
+ *         with the traffic of a RPL node: UDP datagrams to its
+ *         neighbors and to the root, datagrams that it forwards to
+ *         the root, and link-local multicast control messages.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/simple-udp.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_NEIGHBORS 8
+#define NUM_PACKETS   100000
+#define PAYLOAD_LEN   16
+#define UDP_PORT      0xf0b0
+#define MAX_FRAMES    (NUM_NEIGHBORS * 4)
+
+#define UIP_IP_BUF ((struct uip_udpip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+PROCESS(iphc_compression_process, "IPHC compression benchmark");
+AUTOSTART_PROCESSES(&iphc_compression_process);
+
+struct frame {
+  uint8_t len;
+  uint8_t data[PACKETBUF_SIZE];
+  linkaddr_t sender;
+  uip_ipaddr_t srcipaddr;
+  uip_ipaddr_t destipaddr;
+};
+
+static struct frame frames[MAX_FRAMES];
+static int num_frames;
+static int capture;
+
+static linkaddr_t neighbors[NUM_NEIGHBORS];
+static uip_ipaddr_t root_addr;
+
+static struct simple_udp_connection connection;
+static unsigned long delivered;
+static unsigned long mismatches;
+static const struct frame *expected;
+static unsigned long wrong_addresses;
+/*---------------------------------------------------------------------------*/
+/* A MAC layer that captures the frames instead of sending them. */
+static void
+loopback_send(mac_callback_t sent, void *ptr)
+{
+  struct frame *f;
+
+  if(capture && num_frames < MAX_FRAMES) {
+    f = &frames[num_frames++];
+    f->len = packetbuf_datalen();
+    memcpy(f->data, packetbuf_dataptr(), f->len);
+    linkaddr_copy(&f->sender, packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    uip_ipaddr_copy(&f->srcipaddr, &UIP_IP_BUF->srcipaddr);
+    uip_ipaddr_copy(&f->destipaddr, &UIP_IP_BUF->destipaddr);
+  }
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+loopback_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+loopback_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver loopback_mac_driver = {
+  "loopback",
+  loopback_init,
+  loopback_send,
+  loopback_input,
+  loopback_on,
+  loopback_off,
+};
+/*---------------------------------------------------------------------------*/
+static uint8_t
+payload_byte(uint16_t i)
+{
+  return (uint8_t)(i * 7 + 3);
+}
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  uint16_t i;
+
+  delivered++;
+  if(datalen != PAYLOAD_LEN) {
+    mismatches++;
+    return;
+  }
+  for(i = 0; i < datalen; i++) {
+    if(data[i] != payload_byte(i)) {
+      mismatches++;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Compress and send a packet of the traffic of the node */
+static void
+send_packet(int n)
+{
+  const linkaddr_t *dest;
+  int neighbor;
+  uint16_t i;
+
+  neighbor = (n / 4) % NUM_NEIGHBORS;
+
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcf = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->len[0] = 0;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  UIP_IP_BUF->srcport = UIP_HTONS(UDP_PORT + 1);
+  UIP_IP_BUF->destport = UIP_HTONS(UDP_PORT);
+  UIP_IP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_IP_BUF->udpchksum = 0;
+
+  switch(n % 4) {
+  case 0:
+    /* To a neighbor */
+    uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+    uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, &uip_lladdr);
+    uip_ip6addr(&UIP_IP_BUF->destipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+    uip_ds6_set_addr_iid(&UIP_IP_BUF->destipaddr,
+                         (uip_lladdr_t *)&neighbors[neighbor]);
+    dest = &neighbors[neighbor];
+    break;
+  case 1:
+    /* To the root, through the preferred parent. The address of the
+       root against the parent and the address of this node take the
+       same slot of the address cache, with different DAM and SAM
+       modes. */
+    uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+    uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, &uip_lladdr);
+    uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &root_addr);
+    dest = &neighbors[0];
+    break;
+  case 2:
+    /* From a neighbor to the root, forwarded */
+    uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+    uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr,
+                         (uip_lladdr_t *)&neighbors[neighbor]);
+    uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &root_addr);
+    UIP_IP_BUF->ttl = 63;
+    dest = &neighbors[0];
+    break;
+  default:
+    /* A link-local multicast control message */
+    uip_create_linklocal_prefix(&UIP_IP_BUF->srcipaddr);
+    uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, &uip_lladdr);
+    uip_ip6addr(&UIP_IP_BUF->destipaddr, 0xff02, 0, 0, 0, 0, 0, 0, 0x001a);
+    UIP_IP_BUF->ttl = 255;
+    dest = NULL;
+    break;
+  }
+
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_UDPH_LEN + i] = payload_byte(i);
+  }
+  UIP_IP_BUF->udpchksum = ~(uip_udpchksum());
+  if(UIP_IP_BUF->udpchksum == 0) {
+    UIP_IP_BUF->udpchksum = 0xffff;
+  }
+
+  NETSTACK_NETWORK.output(dest);
+  uip_clear_buf();
+}
+/*---------------------------------------------------------------------------*/
+/* Uncompress a frame sent to a neighbor as if the neighbor had sent it
+   to this node. As the addresses are elided against the link-layer
+   addresses, the source and destination of the datagrams to neighbors
+   are swapped, which leaves their checksum valid, so that they are
+   delivered to this node. */
+static void
+receive_frame(const struct frame *f)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(f->data, f->len);
+  if(linkaddr_cmp(&f->sender, &linkaddr_null)) {
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &neighbors[0]);
+  } else {
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &f->sender);
+  }
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Check the addresses of a datagram uncompressed by check_frame(), and
+   drop it. Other datagrams are left alone. */
+static enum netstack_ip_action
+check_addresses(void)
+{
+  if(expected != NULL) {
+    if(!uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &expected->srcipaddr) ||
+       !uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &expected->destipaddr)) {
+      wrong_addresses++;
+    }
+    return NETSTACK_IP_DROP;
+  }
+  return NETSTACK_IP_PROCESS;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor address_checker = {
+  .process_input = check_addresses
+};
+/*---------------------------------------------------------------------------*/
+/* Uncompress a frame as its receiver does, and check that the addresses
+   are those that were compressed */
+static void
+check_frame(const struct frame *f)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(f->data, f->len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &f->sender);
+  expected = f;
+  NETSTACK_NETWORK.input();
+  expected = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_time(const char *what, clock_time_t ticks, unsigned long n)
+{
+  printf("%s %lu packets: %lu ticks (%lu ns per packet)\n", what, n,
+         (unsigned long)ticks,
+         (unsigned long)((unsigned long long)ticks * 1000000000 /
+                         CLOCK_SECOND / n));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(iphc_compression_process, ev, data)
+{
+  static clock_time_t start;
+  static unsigned long num_received;
+  static int n;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Address cache size: %d\n", SICSLOWPAN_CONF_ADDR_CACHE_SIZE);
+
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    memset(&neighbors[i], 0, sizeof(neighbors[i]));
+    neighbors[i].u8[0] = 0x02;
+    neighbors[i].u8[LINKADDR_SIZE - 2] = 0x10;
+    neighbors[i].u8[LINKADDR_SIZE - 1] = i + 1;
+  }
+  /* The root has a 16-bit IID, elided to 16 bits with the prefix */
+  uip_ip6addr(&root_addr, 0xfd00, 0, 0, 0, 0, 0x00ff, 0xfe00, 0x0001);
+
+  simple_udp_register(&connection, UDP_PORT, NULL, UDP_PORT + 1, receiver);
+
+  /* Compression */
+  capture = 0;
+  start = clock_time();
+  for(n = 0; n < NUM_PACKETS; n++) {
+    send_packet(n);
+  }
+  print_time("Compressed", clock_time() - start, NUM_PACKETS);
+
+  /* Uncompression, of a frame of each kind for each neighbor */
+  capture = 1;
+  num_frames = 0;
+  for(n = 0; n < MAX_FRAMES; n++) {
+    send_packet(n);
+  }
+  capture = 0;
+
+  delivered = 0;
+  mismatches = 0;
+  num_received = 0;
+  start = clock_time();
+  for(n = 0; n < NUM_PACKETS / num_frames; n++) {
+    for(i = 0; i < num_frames; i++) {
+      receive_frame(&frames[i]);
+      num_received++;
+    }
+  }
+  print_time("Uncompressed", clock_time() - start, num_received);
+  printf("Delivered datagrams: %lu of %lu\n", delivered, num_received / 4);
+  printf("Mismatching datagrams: %lu\n", mismatches);
+
+  /* The addresses of every kind of frame, as seen by its receiver */
+  netstack_ip_packet_processor_add(&address_checker);
+  for(i = 0; i < num_frames; i++) {
+    check_frame(&frames[i]);
+  }
+  printf("Frames with wrong addresses: %lu of %d\n", wrong_addresses,
+         num_frames);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""A minimal stand-in for an MQTT broker, for the MQTT publish benchmark.
+
+Accepts any CONNECT, acknowledges QoS 1 PUBLISH messages, SUBSCRIBE and
+PINGREQ, and drops the messages themselves. The PUBACKs can be delayed to
+emulate the round trip over a multi-hop network.
+"""
+
+import argparse
+import asyncio
+import struct
+
+
+async def send_later(writer, data, delay):
+    await asyncio.sleep(delay)
+    if not writer.is_closing():
+        writer.write(data)
+
+
+async def read_packet(reader):
+    fhdr = (await reader.readexactly(1))[0]
+    length = 0
+    multiplier = 1
+    while True:
+        byte = (await reader.readexactly(1))[0]
+        length += (byte & 127) * multiplier
+        multiplier *= 128
+        if byte & 128 == 0:
+            break
+    return fhdr, await reader.readexactly(length)
+
+
+async def client(reader, writer, delay):
+    peer = writer.get_extra_info('peername')
+    published = 0
+    duplicates = 0
+    mids = set()
+    try:
+        while True:
+            fhdr, body = await read_packet(reader)
+            kind = fhdr & 0xF0
+            if kind == 0x10:
+                writer.write(b'\x20\x02\x00\x00')
+            elif kind == 0x30:
+                published += 1
+                qos = (fhdr >> 1) & 3
+                if qos > 0:
+                    topic_len = struct.unpack('!H', body[:2])[0]
+                    mid = body[2 + topic_len:4 + topic_len]
+                    duplicates += mid in mids
+                    mids.add(mid)
+                    asyncio.ensure_future(send_later(writer, b'\x40\x02' + mid,
+                                                     delay))
+            elif kind == 0x80:
+                writer.write(b'\x90\x03' + body[:2] + b'\x00')
+            elif kind == 0xA0:
+                writer.write(b'\xb0\x02' + body[:2])
+            elif kind == 0xC0:
+                writer.write(b'\xd0\x00')
+            elif kind == 0xE0:
+                break
+    except (asyncio.IncompleteReadError, ConnectionError):
+        pass
+    print('%s: %d PUBLISH, %d with a reused MID' %
+          (peer[0], published, duplicates), flush=True)
+    writer.close()
+
+
+async def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--port', type=int, default=1883)
+    parser.add_argument('--delay', type=float, default=0,
+                        help='PUBACK delay in milliseconds')
+    args = parser.parse_args()
+
+    server = await asyncio.start_server(
+        lambda r, w: client(r, w, args.delay / 1000), '::', args.port)
+    async with server:
+        await server.serve_forever()
+
+
+if __name__ == '__main__':
+    asyncio.run(main())
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the throughput of QoS 1 MQTT publishing, against
+ *         the broker stand-in in mqtt-broker.py.
+ */
+
+#include "contiki.h"
+#include "mqtt.h"
+#include "net/routing/routing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BROKER_IP_ADDR   "fd00::1"
+#ifndef BROKER_PORT
+#define BROKER_PORT      1883
+#endif
+#define KEEP_ALIVE       60
+#define MAX_SEGMENT_SIZE 512
+
+#define NUM_MESSAGES     200
+#define PAYLOAD_SIZE     48
+
+PROCESS(mqtt_publish_process, "MQTT publish benchmark");
+AUTOSTART_PROCESSES(&mqtt_publish_process);
+
+static struct mqtt_connection conn;
+static char topic[] = "bench/telemetry";
+static uint8_t payload[PAYLOAD_SIZE];
+static uint8_t connected;
+static unsigned long acked;
+static uint16_t last_mid;
+/*---------------------------------------------------------------------------*/
+static void
+mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
+{
+  switch(event) {
+  case MQTT_EVENT_CONNECTED:
+    connected = 1;
+    break;
+  case MQTT_EVENT_DISCONNECTED:
+    connected = 0;
+    break;
+  case MQTT_EVENT_PUBACK:
+    acked++;
+    last_mid = *(uint16_t *)data;
+    break;
+  default:
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mqtt_publish_process, ev, data)
+{
+  static struct etimer et;
+  static clock_time_t start;
+  static unsigned long sent;
+  static uint16_t mid;
+  clock_time_t elapsed;
+
+  PROCESS_BEGIN();
+
+  printf("Streaming: %d, in flight: %d, messages: %d of %d bytes\n",
+         MQTT_STREAMING, MQTT_MAX_INFLIGHT, NUM_MESSAGES, PAYLOAD_SIZE);
+
+  /* Owns the fd00::/64 prefix that the broker is reached through */
+  NETSTACK_ROUTING.root_start();
+
+  memset(payload, 'x', sizeof(payload));
+  mqtt_register(&conn, &mqtt_publish_process, "mqtt-publish", mqtt_event,
+                MAX_SEGMENT_SIZE);
+  mqtt_connect(&conn, BROKER_IP_ADDR, BROKER_PORT, KEEP_ALIVE);
+
+  etimer_set(&et, CLOCK_SECOND * 10);
+  PROCESS_WAIT_UNTIL(connected || etimer_expired(&et));
+  if(!connected) {
+    printf("No broker at [%s]:%u\n", BROKER_IP_ADDR, BROKER_PORT);
+    PROCESS_EXIT();
+  }
+
+  start = clock_time();
+  while(acked < NUM_MESSAGES && connected) {
+    if(sent < NUM_MESSAGES && mqtt_ready(&conn) && conn.out_buffer_sent &&
+       mqtt_publish(&conn, &mid, topic, payload, sizeof(payload),
+                    MQTT_QOS_LEVEL_1, MQTT_RETAIN_OFF) == MQTT_STATUS_OK) {
+      sent++;
+    }
+    PROCESS_WAIT_EVENT();
+  }
+  elapsed = clock_time() - start;
+
+  printf("Published: %lu, acknowledged: %lu, last MID: %u/%u\n",
+         sent, acked, last_mid, mid);
+  printf("Time: %lu ticks (%lu messages/s)\n", (unsigned long)elapsed,
+         (unsigned long)(elapsed > 0 ? acked * CLOCK_SECOND / elapsed : 0));
+
+  conn.auto_reconnect = 0;
+  mqtt_disconnect(&conn);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for uip_ds6_route_lookup(). Fills the routing table
+ *         with a mix of host routes and shorter prefixes, then compares
+ *         lookups through uip-ds6-route against a plain linear
+ *         longest-prefix scan of the route list, as done without
+ *         UIP_DS6_ROUTE_INDEX.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define NUM_NEXTHOPS     8
+#define NUM_HOST_ROUTES  (UIP_DS6_ROUTE_NB - 64)
+#define NUM_LOOKUPS      200000UL
+
+PROCESS(route_lookup_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_process);
+
+static uip_ipaddr_t dests[UIP_DS6_ROUTE_NB];
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+linear_lookup(uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *found_route;
+  uint8_t longestmatch;
+
+  found_route = NULL;
+  longestmatch = 0;
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if(r->length >= longestmatch &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      longestmatch = r->length;
+      found_route = r;
+      if(longestmatch == 128) {
+        break;
+      }
+    }
+  }
+  return found_route;
+}
+/*---------------------------------------------------------------------------*/
+static void
+setup_routes(void)
+{
+  uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+  uip_lladdr_t lladdr;
+  uip_ipaddr_t prefix;
+  int i;
+
+  for(i = 0; i < NUM_NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr.addr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                    NBR_TABLE_REASON_UNDEFINED, NULL);
+  }
+
+  /* Host routes below fd00::/64, as learnt from DAOs */
+  for(i = 0; i < NUM_HOST_ROUTES; i++) {
+    uip_ip6addr(&dests[i], 0xfd00, 0, 0, 0,
+                0x0212, 0x4b00, random_rand(), i + 1);
+    uip_ds6_route_add(&dests[i], 128, &nexthops[i % NUM_NEXTHOPS]);
+  }
+
+  /* Shorter prefixes, e.g. delegated to other routers */
+  for(i = NUM_HOST_ROUTES; i < UIP_DS6_ROUTE_NB; i++) {
+    uip_ip6addr(&prefix, 0xfd00, 0, 0, i, 0, 0, 0, 0);
+    uip_ds6_route_add(&prefix, 64, &nexthops[i % NUM_NEXTHOPS]);
+    uip_ip6addr(&dests[i], 0xfd00, 0, 0, i, 0, 0, 0, random_rand());
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+run(uip_ds6_route_t *(*lookup)(uip_ipaddr_t *))
+{
+  unsigned long i;
+  clock_time_t start;
+
+  start = clock_time();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    lookup(&dests[random_rand() % UIP_DS6_ROUTE_NB]);
+  }
+  return (unsigned long)(clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_process, ev, data)
+{
+  unsigned long ticks;
+  int i;
+  int mismatches;
+
+  PROCESS_BEGIN();
+
+  setup_routes();
+  printf("Routes: %d (index %s)\n", uip_ds6_route_num_routes(),
+         UIP_DS6_ROUTE_INDEX ? "enabled" : "disabled");
+
+  mismatches = 0;
+  for(i = 0; i < UIP_DS6_ROUTE_NB; i++) {
+    if(uip_ds6_route_lookup(&dests[i]) != linear_lookup(&dests[i])) {
+      mismatches++;
+    }
+  }
+  printf("Mismatching lookups: %d\n", mismatches);
+
+  ticks = run(linear_lookup);
+  printf("Linear scan:          %lu lookups in %lu ticks (%lu ticks/s)\n",
+         NUM_LOOKUPS, ticks, (unsigned long)CLOCK_SECOND);
+  ticks = run(uip_ds6_route_lookup);
+  printf("uip_ds6_route_lookup: %lu lookups in %lu ticks (%lu ticks/s)\n",
+         NUM_LOOKUPS, ticks, (unsigned long)CLOCK_SECOND);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the parent selection of RPL Lite in a dense
+ *         neighborhood, as DIOs are received and link statistics are
+ *         updated.
+ */
+
+#include "contiki.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "net/link-stats.h"
+#include "net/packetbuf.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_NBRS     36
+#define NUM_EVENTS   200000
+/* Events that are DIOs, out of 16; the others are link updates */
+#define DIO_EVENTS   12
+
+PROCESS(rpl_parents_process, "RPL parent selection benchmark");
+AUTOSTART_PROCESSES(&rpl_parents_process);
+
+static rpl_dio_t dio;
+static rpl_rank_t ranks[NUM_NBRS];
+static unsigned long selections;
+static unsigned long compared;
+static unsigned long computed;
+static uint32_t rnd = 1;
+/*---------------------------------------------------------------------------*/
+void
+parent_evaluation(unsigned nbrs_compared, unsigned nbrs_computed)
+{
+  selections++;
+  compared += nbrs_compared;
+  computed += nbrs_computed;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+random_next(void)
+{
+  rnd ^= rnd << 13;
+  rnd ^= rnd >> 17;
+  rnd ^= rnd << 5;
+  return rnd;
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_lladdr(linkaddr_t *lladdr, int i)
+{
+  memset(lladdr, 0, sizeof(*lladdr));
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 1] = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive_dio(int i)
+{
+  uip_ipaddr_t from;
+  linkaddr_t lladdr;
+
+  nbr_lladdr(&lladdr, i);
+  uip_ip6addr(&from, 0xfe80, 0, 0, 0, 0x0002, 0, 0, i + 1);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &lladdr);
+  dio.rank = ranks[i];
+  rpl_process_dio(&from, &dio);
+}
+/*---------------------------------------------------------------------------*/
+static void
+packet_sent(int i, int status, int numtx)
+{
+  linkaddr_t lladdr;
+
+  nbr_lladdr(&lladdr, i);
+  link_stats_packet_sent(&lladdr, status, numtx);
+  NETSTACK_ROUTING.link_callback(&lladdr, status, numtx);
+  /* The state update that the link callback postpones */
+  rpl_dag_update_state();
+}
+/*---------------------------------------------------------------------------*/
+static int
+parent_index(void)
+{
+  const linkaddr_t *lladdr;
+
+  lladdr = rpl_neighbor_get_lladdr(curr_instance.dag.preferred_parent);
+  return lladdr != NULL ? lladdr->u8[LINKADDR_SIZE - 1] : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rpl_parents_process, ev, data)
+{
+  static clock_time_t start;
+  static unsigned long n;
+  static uint32_t choices;
+  static unsigned switches;
+  static int last_parent;
+  uint32_t r;
+  int parent;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Parent candidates: %d, neighbors: %d\n",
+         RPL_PARENT_CANDIDATES, NUM_NBRS);
+
+  uip_ip6addr(&dio.dag_id, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  dio.ocp = RPL_OCP_MRHOF;
+  dio.grounded = 1;
+  dio.mop = RPL_MOP_NON_STORING;
+  dio.version = RPL_LOLLIPOP_INIT;
+  dio.instance_id = RPL_DEFAULT_INSTANCE;
+  dio.dtsn = RPL_LOLLIPOP_INIT;
+  dio.dag_intdoubl = RPL_DIO_INTERVAL_DOUBLINGS;
+  dio.dag_intmin = RPL_DIO_INTERVAL_MIN;
+  dio.dag_redund = RPL_DIO_REDUNDANCY;
+  dio.default_lifetime = RPL_DEFAULT_LIFETIME;
+  dio.lifetime_unit = RPL_DEFAULT_LIFETIME_UNIT;
+  dio.dag_max_rankinc = RPL_MAX_RANKINC;
+  dio.dag_min_hoprankinc = RPL_MIN_HOPRANKINC;
+  uip_ip6addr(&dio.prefix_info.prefix, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  dio.prefix_info.length = 64;
+  dio.prefix_info.flags = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  dio.prefix_info.lifetime = RPL_ROUTE_INFINITE_LIFETIME;
+  dio.mc.type = RPL_DAG_MC_NONE;
+
+  /* Neighbors from one to five hops away from the root, with fresh
+     link statistics */
+  for(i = 0; i < NUM_NBRS; i++) {
+    ranks[i] = RPL_MIN_HOPRANKINC * (2 + i % 5) + (i * 37) % 64;
+    receive_dio(i);
+    for(n = 0; n < 8; n++) {
+      packet_sent(i, MAC_TX_OK, 1 + (i + n) % 3);
+    }
+  }
+  printf("Neighbors: %d, rank: %u\n",
+         rpl_neighbor_count(), curr_instance.dag.rank);
+
+  selections = 0;
+  compared = 0;
+  computed = 0;
+  choices = 0;
+  switches = 0;
+  last_parent = parent_index();
+  start = clock_time();
+  for(n = 0; n < NUM_EVENTS; n++) {
+    r = random_next();
+    i = (r >> 8) % NUM_NBRS;
+    if((r & 15) < DIO_EVENTS) {
+      /* Most DIOs advertise the same rank as before */
+      if((r >> 16) % 16 == 0) {
+        ranks[i] = RPL_MIN_HOPRANKINC * 2 + (r >> 20) % (4 * RPL_MIN_HOPRANKINC);
+      }
+      receive_dio(i);
+    } else {
+      packet_sent(i, (r >> 16) % 8 == 0 ? MAC_TX_NOACK : MAC_TX_OK,
+                  1 + (r >> 20) % 3);
+    }
+    parent = parent_index();
+    switches += parent != last_parent;
+    last_parent = parent;
+    choices = (choices << 8) ^ (choices >> 24) ^ parent;
+  }
+  printf("Events: %lu ticks (%lu ns each)\n",
+         (unsigned long)(clock_time() - start),
+         (unsigned long)((unsigned long long)(clock_time() - start) *
+                         1000000000 / CLOCK_SECOND / NUM_EVENTS));
+  printf("Selections: %lu, per selection: %lu.%02lu neighbors compared, %lu.%02lu OF computations\n",
+         selections,
+         compared / selections, compared * 100 / selections % 100,
+         computed / selections, computed * 100 / selections % 100);
+  printf("Parent switches: %u, choices: 0x%08lx, final rank: %u\n",
+         switches, (unsigned long)choices, curr_instance.dag.rank);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the process scheduler, with 64 application
+ *         processes and one network process. A driver process polls
+ *         the processes and posts events to them in bursts, as the
+ *         drivers of a busy radio would, and checks that every poll
+ *         and every posted event is delivered exactly once.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define NUM_WORKERS        64
+#define NUM_ROUNDS         20000UL
+#define MAX_POLLS_PER_ROUND 16
+#define MAX_POSTS_PER_ROUND 40
+#define WORK_PER_EVENT     200
+
+PROCESS(driver_process, "Scheduler benchmark");
+PROCESS(worker_process, "Worker");
+PROCESS(network_process, "Network");
+AUTOSTART_PROCESSES(&driver_process);
+
+static struct process workers[NUM_WORKERS];
+static uint8_t poll_pending[NUM_WORKERS + 1];
+
+static process_event_t work_event;
+static unsigned long polls_requested;
+static unsigned long polls_received;
+static unsigned long events_posted;
+static unsigned long events_received;
+static unsigned long events_lost;
+static unsigned long mismatches;
+/*---------------------------------------------------------------------------*/
+/* Some work for each delivered event, so that the events wait for
+   each other. */
+static void
+work(void)
+{
+  static volatile unsigned long sink;
+  unsigned long i;
+
+  for(i = 0; i < WORK_PER_EVENT; i++) {
+    sink += i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_event(int index, process_event_t ev)
+{
+  if(ev == PROCESS_EVENT_POLL) {
+    if(!poll_pending[index]) {
+      mismatches++;
+    }
+    poll_pending[index] = 0;
+    polls_received++;
+  } else if(ev == work_event) {
+    events_received++;
+  }
+  work();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(worker_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    handle_event(PROCESS_CURRENT() - workers, ev);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(network_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  process_set_priority(PROCESS_CURRENT(), PROCESS_PRIORITY_HIGH);
+  while(1) {
+    PROCESS_YIELD();
+    handle_event(NUM_WORKERS, ev);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+poll(int index)
+{
+  if(!poll_pending[index]) {
+    poll_pending[index] = 1;
+    polls_requested++;
+  }
+  process_poll(index == NUM_WORKERS ? &network_process : &workers[index]);
+}
+/*---------------------------------------------------------------------------*/
+static void
+post(struct process *p)
+{
+  if(process_post(p, work_event, NULL) == PROCESS_ERR_OK) {
+    events_posted++;
+  } else {
+    events_lost++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+burst(void)
+{
+  unsigned n;
+
+  for(n = random_rand() % MAX_POLLS_PER_ROUND; n > 0; n--) {
+    poll(random_rand() % NUM_WORKERS);
+  }
+  poll(NUM_WORKERS);
+  for(n = random_rand() % MAX_POSTS_PER_ROUND; n > 0; n--) {
+    if(n % 8 == 0) {
+      post(&network_process);
+    } else {
+      post(&workers[random_rand() % NUM_WORKERS]);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+static void
+print_latency(const char *name, struct process *p, int n)
+{
+  unsigned long dispatched = 0;
+  unsigned long total = 0;
+  unsigned long max = 0;
+
+  for(; n > 0; n--, p++) {
+    dispatched += p->dispatched;
+    total += p->total_latency;
+    if(p->max_latency > max) {
+      max = p->max_latency;
+    }
+  }
+  printf("%s: %lu dispatches, latency average %lu.%03lu max %lu "
+         "(ticks, %lu ticks/s)\n", name, dispatched,
+         total / dispatched, total * 1000 / dispatched % 1000, max,
+         (unsigned long)RTIMER_SECOND);
+}
+#endif /* PROCESS_CONF_STATS */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(driver_process, ev, data)
+{
+  static clock_time_t start;
+  static unsigned long round;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Poll queue: %d, events per run: %d, priorities: %d\n",
+         PROCESS_POLL_QUEUE, PROCESS_EVENTS_PER_RUN, PROCESS_PRIORITIES);
+
+  work_event = process_alloc_event();
+  for(i = 0; i < NUM_WORKERS; i++) {
+    workers[i] = worker_process;
+    process_start(&workers[i], NULL);
+  }
+  process_start(&network_process, NULL);
+
+  start = clock_time();
+  for(round = 0; round < NUM_ROUNDS; round++) {
+    /* Post the event to continue before the burst, which may fill
+       the event queue. */
+    process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+    burst();
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    /* Let the processes handle the burst. */
+    while(events_received < events_posted ||
+          polls_received < polls_requested) {
+      PROCESS_PAUSE();
+    }
+  }
+  printf("%lu rounds with %u processes: %lu ticks (%lu ticks/s)\n",
+         NUM_ROUNDS, NUM_WORKERS + 1,
+         (unsigned long)(clock_time() - start), (unsigned long)CLOCK_SECOND);
+
+  for(i = 0; i <= NUM_WORKERS; i++) {
+    if(poll_pending[i]) {
+      mismatches++;
+    }
+  }
+  if(polls_received != polls_requested ||
+     events_received != events_posted) {
+    mismatches++;
+  }
+  printf("Polls: %lu, events: %lu, lost events: %lu\n",
+         polls_received, events_received, events_lost);
+  printf("Mismatching deliveries: %lu\n", mismatches);
+
+#if PROCESS_CONF_STATS
+  printf("Maximum queued events: %u\n", process_maxevents);
+  print_latency("Network process", &network_process, 1);
+  print_latency("Worker processes", workers, NUM_WORKERS);
+#endif /* PROCESS_CONF_STATS */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the SLIP encoding and decoding of the native border
+ *         router, over a socket pair that stands in for a USB-CDC radio.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "lib/random.h"
+#include "cmd.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <err.h>
+
+#ifndef FRAME_LEN
+#define FRAME_LEN  127
+#endif
+#define BATCH      8
+#define ROUNDS     100000
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+PROCESS(slip_throughput_process, "SLIP throughput benchmark");
+AUTOSTART_PROCESSES(&slip_throughput_process);
+
+/* From slip-dev.c */
+extern int slipfd;
+void write_to_slip(const uint8_t *buf, int len);
+void slip_flushbuf(int fd);
+int slip_empty(void);
+void serial_input(FILE *inslip);
+
+/* What slip-config.c and border-router-cmds.c provide to slip-dev.c */
+int slip_config_verbose = 0;
+int slip_config_flowcontrol = 0;
+const char *slip_config_siodev = NULL;
+const char *slip_config_host = NULL;
+const char *slip_config_port = NULL;
+uint16_t slip_config_basedelay = 0;
+speed_t slip_config_b_rate = B115200;
+uint8_t command_context;
+
+static uint8_t frames[BATCH][FRAME_LEN];
+/* The SLIP stream of one batch of frames, as the radio sends it */
+static uint8_t stream[BATCH * (2 * FRAME_LEN + 1)];
+static int stream_len;
+static uint8_t rxbuf[4096];
+static unsigned long frames_in, errors_in;
+/*---------------------------------------------------------------------------*/
+int
+cmd_input(const uint8_t *data, int data_len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+devopen(const char *dev, int flags)
+{
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+packet_input(void)
+{
+  if(packetbuf_datalen() != FRAME_LEN ||
+     memcmp(packetbuf_dataptr(), frames[frames_in % BATCH],
+            FRAME_LEN) != 0) {
+    errors_in++;
+  }
+  frames_in++;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver slip_throughput_mac_driver = {
+  "slip-throughput",
+  init,
+  send_packet,
+  packet_input,
+  on,
+  off
+};
+/*---------------------------------------------------------------------------*/
+static int
+encode(uint8_t *out, const uint8_t *frame)
+{
+  int i, len = 0;
+
+  for(i = 0; i < FRAME_LEN; i++) {
+    if(frame[i] == SLIP_END) {
+      out[len++] = SLIP_ESC;
+      out[len++] = SLIP_ESC_END;
+    } else if(frame[i] == SLIP_ESC) {
+      out[len++] = SLIP_ESC;
+      out[len++] = SLIP_ESC_ESC;
+    } else {
+      out[len++] = frame[i];
+    }
+  }
+  out[len++] = SLIP_END;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+drain(int fd)
+{
+  unsigned long total = 0;
+  ssize_t n;
+
+  while((n = read(fd, rxbuf, sizeof(rxbuf))) > 0) {
+    total += n;
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_rate(const char *what, unsigned long bytes, clock_time_t elapsed)
+{
+  if(elapsed == 0) {
+    elapsed = 1;
+  }
+  printf("%s: %lu ticks (%lu kB/s)\n", what, (unsigned long)elapsed,
+         (unsigned long)(bytes * CLOCK_SECOND / elapsed / 1000));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(slip_throughput_process, ev, data)
+{
+  static int sv[2];
+  FILE *in;
+  clock_time_t start;
+  unsigned long sent, expected;
+  int bufsize = 1 << 20;
+  int i, j;
+
+  PROCESS_BEGIN();
+
+  printf("Bulk: %d, frames: %d of %d bytes, %d per write\n",
+         SLIP_DEV_CONF_BULK, BATCH * ROUNDS, FRAME_LEN, BATCH);
+
+  /* 802.15.4 data frames with random payloads, two bytes of which are
+     on average END or ESC */
+  random_init(0);
+  for(i = 0; i < BATCH; i++) {
+    frames[i][0] = 0x41;
+    frames[i][1] = 0xd8;
+    for(j = 2; j < FRAME_LEN; j++) {
+      frames[i][j] = random_rand();
+    }
+    frames[i][FRAME_LEN - 1] = 0xff;
+  }
+  for(i = 0; i < BATCH; i++) {
+    stream_len += encode(stream + stream_len, frames[i]);
+  }
+
+  if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1) {
+    err(1, "socketpair");
+  }
+  for(i = 0; i < 2; i++) {
+    fcntl(sv[i], F_SETFL, O_NONBLOCK);
+    setsockopt(sv[i], SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+  }
+  slipfd = sv[0];
+  in = fdopen(sv[0], "r");
+  if(in == NULL) {
+    err(1, "fdopen");
+  }
+
+  /* Border router to radio: encode each batch and flush it */
+  sent = 0;
+  start = clock_time();
+  for(i = 0; i < ROUNDS; i++) {
+    for(j = 0; j < BATCH; j++) {
+      write_to_slip(frames[j], FRAME_LEN);
+    }
+    while(!slip_empty()) {
+      slip_flushbuf(slipfd);
+    }
+    sent += drain(sv[1]);
+  }
+  print_rate("Encode", (unsigned long)BATCH * ROUNDS * FRAME_LEN,
+             clock_time() - start);
+  expected = (unsigned long)stream_len * ROUNDS;
+  printf("Sent %lu bytes, expected %lu\n", sent, expected);
+
+  /* Radio to border router: a batch of frames per read */
+  start = clock_time();
+  for(i = 0; i < ROUNDS; i++) {
+    if(write(sv[1], stream, stream_len) != stream_len) {
+      err(1, "write");
+    }
+    serial_input(in);
+  }
+  print_rate("Decode", (unsigned long)BATCH * ROUNDS * FRAME_LEN,
+             clock_time() - start);
+  printf("Received %lu frames, %lu wrong\n", frames_in, errors_in);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
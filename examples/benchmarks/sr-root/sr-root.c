@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the source routes of a non-storing RPL root:
+ *         node lookups, and insertion of the source routing header of
+ *         the packets to the nodes of a large DODAG.
+ */
+
+#include "contiki.h"
+#include "net/routing/routing.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-sr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_NODES    500
+#define FANOUT       3
+#define NUM_LOOKUPS  1000000
+#define NUM_PACKETS  500000
+#define PAYLOAD_LEN  32
+/* Packets to the most recent destinations, out of all packets */
+#define HOT_NODES    32
+#define HOT_PERCENT  80
+
+#define UIP_IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_RH_BUF ((struct uip_routing_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+
+PROCESS(sr_root_process, "Source routing root benchmark");
+AUTOSTART_PROCESSES(&sr_root_process);
+
+static uip_ipaddr_t root_addr;
+static uint16_t parents[NUM_NODES];
+/*---------------------------------------------------------------------------*/
+static void
+node_addr(uip_ipaddr_t *addr, int i)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, 0, i + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+parent_addr(uip_ipaddr_t *addr, int i)
+{
+  if(i < FANOUT) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    node_addr(addr, parents[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_node(int i)
+{
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+
+  node_addr(&child, i);
+  parent_addr(&parent, i);
+  uip_sr_update_node(NULL, &child, &parent, 1800);
+}
+/*---------------------------------------------------------------------------*/
+/* The destination of the n-th packet: mostly a few hot nodes, as when
+   the root answers requests, and otherwise any node */
+static int
+packet_dest(unsigned long n)
+{
+  unsigned long r = n * 2654435761UL;
+  if((r >> 8) % 100 < HOT_PERCENT) {
+    return NUM_NODES - 1 - (int)((r >> 16) % HOT_NODES);
+  }
+  return (int)((r >> 16) % NUM_NODES);
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_packet(int i)
+{
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+  memset(UIP_IP_BUF, 0, uip_len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_addr);
+  node_addr(&UIP_IP_BUF->destipaddr, i);
+
+  return NETSTACK_ROUTING.ext_header_update();
+}
+/*---------------------------------------------------------------------------*/
+/* Check the source route of the last packet to node i against the
+   parents of the nodes */
+static int
+check_packet(int i)
+{
+  uip_ipaddr_t addr;
+  int depth = 0;
+  int hop = i;
+
+  while(hop >= FANOUT) {
+    hop = parents[hop];
+    depth++;
+  }
+  node_addr(&addr, hop);
+  if(depth == 0) {
+    /* Direct child of the root: SRH without addresses */
+    return uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr);
+  }
+  return UIP_IP_BUF->proto == UIP_PROTO_ROUTING
+    && UIP_RH_BUF->seg_left == depth
+    && uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr);
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_time(const char *what, clock_time_t ticks, unsigned long n)
+{
+  printf("%s: %lu ticks (%lu ns each)\n", what, (unsigned long)ticks,
+         (unsigned long)((unsigned long long)ticks * 1000000000 /
+                         CLOCK_SECOND / n));
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+check_all(void)
+{
+  unsigned long mismatches = 0;
+  int i;
+
+  for(i = 0; i < NUM_NODES; i++) {
+    if(!send_packet(i) || !check_packet(i)) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sr_root_process, ev, data)
+{
+  static clock_time_t start;
+  static unsigned long n;
+  static unsigned long found;
+  uip_ipaddr_t addr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Node hash size: %d, path cache size: %d\n",
+         UIP_SR_NODE_HASH_SIZE, UIP_SR_PATH_CACHE_SIZE);
+
+  NETSTACK_ROUTING.root_start();
+  NETSTACK_ROUTING.get_root_ipaddr(&root_addr);
+
+  /* A DODAG where node i is a child of node (i - FANOUT) / FANOUT */
+  for(i = 0; i < NUM_NODES; i++) {
+    parents[i] = i < FANOUT ? 0 : (i - FANOUT) / FANOUT;
+    update_node(i);
+  }
+  printf("Nodes: %d\n", uip_sr_num_nodes());
+
+  found = 0;
+  start = clock_time();
+  for(n = 0; n < NUM_LOOKUPS; n++) {
+    node_addr(&addr, packet_dest(n));
+    found += uip_sr_get_node(NULL, &addr) != NULL;
+  }
+  print_time("Node lookup", clock_time() - start, NUM_LOOKUPS);
+  printf("Nodes found: %lu of %lu\n", found, (unsigned long)NUM_LOOKUPS);
+
+  start = clock_time();
+  for(n = 0; n < NUM_PACKETS; n++) {
+    send_packet(packet_dest(n));
+  }
+  print_time("SRH insertion", clock_time() - start, NUM_PACKETS);
+  printf("Mismatching routes: %lu\n", check_all());
+
+  /* Move a subtree, the routes through it must change */
+  parents[FANOUT * 2] = 2;
+  update_node(FANOUT * 2);
+  printf("Mismatching routes after a parent change: %lu\n", check_all());
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for event timers and callback timers, with 500
+ *         timers pending at the same time. First measures the cost of
+ *         setting and stopping timers, then lets all timers run for
+ *         a while and checks that none of them expires early.
+ *         Last, stops a callback timer whose expiry event is still
+ *         queued and reuses its memory, to check that the event does
+ *         not reach the reused memory.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_ETIMERS   250
+#define NUM_CTIMERS   250
+#define NUM_OPS       100000UL
+#define NUM_CHECKS    10000
+#define RUN_TIME      (5 * CLOCK_SECOND)
+
+PROCESS(timer_load_process, "Timer benchmark");
+AUTOSTART_PROCESSES(&timer_load_process);
+
+static struct etimer etimers[NUM_ETIMERS];
+static struct ctimer ctimers[NUM_CTIMERS];
+
+static unsigned long mismatches;
+static unsigned long expirations;
+static unsigned long early;
+static clock_time_t max_lateness;
+static uint8_t running;
+static struct ctimer reused;
+static unsigned long stale_callbacks;
+/*---------------------------------------------------------------------------*/
+/* An interval typical of protocol timers: from 10 ms to 1 s. */
+static clock_time_t
+random_interval(void)
+{
+  return CLOCK_SECOND / 100 + random_rand() % CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+/* A long interval, for timers that must not expire during the test. */
+static clock_time_t
+long_interval(void)
+{
+  return 60 * CLOCK_SECOND + random_rand() % (60 * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_expiration(struct timer *t)
+{
+  clock_time_t late;
+
+  expirations++;
+  if(!timer_expired(t)) {
+    early++;
+    return;
+  }
+  late = clock_time() - t->start - t->interval;
+  if(late > max_lateness) {
+    max_lateness = late;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctimer_callback(void *ptr)
+{
+  struct ctimer *c = ptr;
+
+  check_expiration(&c->etimer.timer);
+  if(running) {
+    ctimer_set(c, random_interval(), ctimer_callback, c);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stale_callback(void *ptr)
+{
+  stale_callbacks++;
+}
+/*---------------------------------------------------------------------------*/
+/* Compare the next expiration time with the earliest pending timer. */
+static void
+check_next_expiration(void)
+{
+  struct etimer *first;
+  struct etimer *et;
+  int i;
+
+  first = NULL;
+  for(i = 0; i < NUM_ETIMERS + NUM_CTIMERS; i++) {
+    et = i < NUM_ETIMERS ? &etimers[i] : &ctimers[i - NUM_ETIMERS].etimer;
+    if(!etimer_expired(et) &&
+       (first == NULL ||
+        (long)(etimer_expiration_time(et) -
+               etimer_expiration_time(first)) < 0)) {
+      first = et;
+    }
+  }
+  if(first == NULL ? etimer_pending() :
+     etimer_next_expiration_time() != etimer_expiration_time(first)) {
+    mismatches++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+reschedule(unsigned long ops, int check)
+{
+  unsigned long op;
+  unsigned r;
+  int i;
+
+  for(op = 0; op < ops; op++) {
+    r = random_rand() % 10;
+    if(r < 4) {
+      etimer_set(&etimers[random_rand() % NUM_ETIMERS], long_interval());
+    } else if(r < 5) {
+      etimer_stop(&etimers[random_rand() % NUM_ETIMERS]);
+    } else if(r < 9) {
+      i = random_rand() % NUM_CTIMERS;
+      ctimer_set(&ctimers[i], long_interval(), ctimer_callback, &ctimers[i]);
+    } else {
+      ctimer_stop(&ctimers[random_rand() % NUM_CTIMERS]);
+    }
+    if(check) {
+      check_next_expiration();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(timer_load_process, ev, data)
+{
+  static clock_time_t start;
+  static int i;
+
+  PROCESS_BEGIN();
+
+  printf("Timer heap: %d\n", ETIMER_HEAP);
+
+  /* Set and stop timers while all of them are pending. */
+  for(i = 0; i < NUM_ETIMERS; i++) {
+    etimer_set(&etimers[i], long_interval());
+  }
+  for(i = 0; i < NUM_CTIMERS; i++) {
+    ctimer_set(&ctimers[i], long_interval(), ctimer_callback, &ctimers[i]);
+  }
+  start = clock_time();
+  reschedule(NUM_OPS, 0);
+  printf("%lu set/stop operations with %u timers: %lu ticks "
+         "(%lu ticks/s)\n", NUM_OPS, NUM_ETIMERS + NUM_CTIMERS,
+         (unsigned long)(clock_time() - start),
+         (unsigned long)CLOCK_SECOND);
+  reschedule(NUM_CHECKS, 1);
+  printf("Mismatching next expirations: %lu\n", mismatches);
+
+  /* Let all timers expire repeatedly. */
+  for(i = 0; i < NUM_ETIMERS; i++) {
+    etimer_set(&etimers[i], random_interval());
+  }
+  for(i = 0; i < NUM_CTIMERS; i++) {
+    ctimer_set(&ctimers[i], random_interval(), ctimer_callback, &ctimers[i]);
+  }
+  running = 1;
+  start = clock_time();
+  while(clock_time() - start < RUN_TIME) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if((struct etimer *)data >= &etimers[0] &&
+       (struct etimer *)data < &etimers[NUM_ETIMERS]) {
+      check_expiration(&((struct etimer *)data)->timer);
+      etimer_set(data, random_interval());
+    }
+  }
+  running = 0;
+  for(i = 0; i < NUM_ETIMERS; i++) {
+    etimer_stop(&etimers[i]);
+  }
+  for(i = 0; i < NUM_CTIMERS; i++) {
+    ctimer_stop(&ctimers[i]);
+  }
+
+  printf("Expirations in %lu s: %lu\n",
+         (unsigned long)(RUN_TIME / CLOCK_SECOND), expirations);
+  printf("Maximum lateness: %lu ticks\n", (unsigned long)max_lateness);
+  printf("Early expirations: %lu\n", early);
+  printf("Pending timers after stopping: %d\n", etimer_pending());
+
+  /* Let a ctimer expire, so that its event is queued behind ours. */
+  ctimer_set(&reused, 1, stale_callback, NULL);
+  while(!timer_expired(&reused.etimer.timer));
+  PROCESS_PAUSE();
+  ctimer_stop(&reused);
+  /* Reuse the memory as an expired, armed ctimer, which is what the
+     queued event would find if it were delivered. */
+  memset(&reused, 0, sizeof(reused));
+#if ETIMER_HEAP
+  reused.armed = 1;
+#endif /* ETIMER_HEAP */
+  reused.f = stale_callback;
+  PROCESS_PAUSE();
+  printf("Callbacks through stopped ctimers: %lu\n", stale_callbacks);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
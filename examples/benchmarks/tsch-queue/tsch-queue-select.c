@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for the selection of unicast packets in shared slots,
+ *         as done by the TSCH slot operation on a coordinator with 60
+ *         neighbors, a few of which have packets queued at any time.
+ *         Compares tsch_queue_get_unicast_packet_for_any() with a scan
+ *         of all neighbors, as done without TSCH_QUEUE_WITH_ACTIVE_SET.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/packetbuf.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define NUM_NEIGHBORS 60
+#define NUM_PENDING   8
+#define NUM_SLOTS     200000UL
+
+PROCESS(tsch_queue_process, "TSCH queue benchmark");
+AUTOSTART_PROCESSES(&tsch_queue_process);
+
+/* Stubs for the parts of TSCH used by the queue module */
+static int locked;
+int tsch_is_coordinator = 1;
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0 } };
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+
+static struct tsch_neighbor *neighbors[NUM_NEIGHBORS];
+static struct tsch_link shared_link;
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_addr(linkaddr_t *addr, int i)
+{
+  linkaddr_copy(addr, &linkaddr_null);
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 1] = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_packet *
+add_packet(int i, int is_control)
+{
+  linkaddr_t addr;
+
+  neighbor_addr(&addr, i);
+  packetbuf_clear();
+  packetbuf_set_datalen(40);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  /* ICMPv6, as set by 6LoWPAN for RPL control messages */
+  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, is_control ? 58 : 17);
+  return tsch_queue_add_packet(&addr, 8, NULL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Reference: is there a neighbor that may send in the shared slot? */
+static int
+any_neighbor_ready(void)
+{
+  int i;
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    if(neighbors[i]->tx_links_count == 0
+       && tsch_queue_get_packet_for_nbr(neighbors[i], &shared_link) != NULL) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Run the shared slots: send a packet if any neighbor may, with one
+ * transmission in four failing, and queue a new packet for every
+ * packet that leaves the queues */
+static unsigned long
+run(unsigned long *sent, unsigned long *mismatches)
+{
+  struct tsch_neighbor *n;
+  struct tsch_packet *p;
+  unsigned long slot;
+  clock_time_t start;
+  uint8_t status;
+
+  *sent = 0;
+  start = clock_time();
+  for(slot = 0; slot < NUM_SLOTS; slot++) {
+    p = tsch_queue_get_unicast_packet_for_any(&n, &shared_link);
+    if(mismatches != NULL && (p != NULL) != any_neighbor_ready()) {
+      (*mismatches)++;
+    }
+    if(p != NULL) {
+      p->transmissions++;
+      status = (random_rand() & 3) == 0 ? MAC_TX_NOACK : MAC_TX_OK;
+      if(status == MAC_TX_OK) {
+        (*sent)++;
+      }
+      if(!tsch_queue_packet_sent(n, p, &shared_link, status)) {
+        tsch_queue_free_packet(p);
+        add_packet(random_rand() % NUM_NEIGHBORS, 0);
+      }
+    }
+    tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  }
+  return (unsigned long)(clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_queue_process, ev, data)
+{
+  struct tsch_packet *control_packet;
+  unsigned long ticks, sent, mismatches;
+  linkaddr_t addr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  tsch_queue_init();
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    neighbor_addr(&addr, i);
+    neighbors[i] = tsch_queue_add_nbr(&addr);
+  }
+  shared_link.link_options = LINK_OPTION_TX | LINK_OPTION_SHARED;
+  linkaddr_copy(&shared_link.addr, &tsch_broadcast_address);
+
+  printf("Neighbors: %d (active set %s, priorities %s)\n", NUM_NEIGHBORS,
+         TSCH_QUEUE_WITH_ACTIVE_SET ? "enabled" : "disabled",
+         TSCH_QUEUE_WITH_PRIORITIES ? "enabled" : "disabled");
+
+  /* A control packet queued after a data packet is sent first with
+   * priorities */
+  add_packet(0, 0);
+  control_packet = add_packet(0, 1);
+  printf("First packet: %s\n",
+         tsch_queue_get_packet_for_nbr(neighbors[0], &shared_link)
+         == control_packet ? "control" : "data");
+  tsch_queue_free_packet(tsch_queue_remove_packet_from_queue(neighbors[0]));
+  tsch_queue_free_packet(tsch_queue_remove_packet_from_queue(neighbors[0]));
+
+  random_init(1);
+  for(i = 0; i < NUM_PENDING; i++) {
+    add_packet(random_rand() % NUM_NEIGHBORS, 0);
+  }
+  mismatches = 0;
+  run(&sent, &mismatches);
+  printf("Mismatching slots: %lu\n", mismatches);
+
+  ticks = run(&sent, NULL);
+  printf("%lu shared slots in %lu ticks (%lu ticks/s), %lu packets sent\n",
+         NUM_SLOTS, ticks, (unsigned long)CLOCK_SECOND, sent);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
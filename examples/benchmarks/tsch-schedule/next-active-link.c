@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark for tsch_schedule_get_next_active_link(). Installs an
+ *         Orchestra-like schedule of 128 links over 4 slotframes, then
+ *         compares next-link selection with a linear scan of all links,
+ *         as done without TSCH_SCHEDULE_WITH_LINK_INDEX.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define NUM_LOOKUPS 200000UL
+
+PROCESS(tsch_schedule_process, "TSCH schedule benchmark");
+AUTOSTART_PROCESSES(&tsch_schedule_process);
+
+/* Stubs for the parts of TSCH used by the schedule module */
+static int locked;
+static struct tsch_neighbor neighbor;
+struct tsch_link *current_link;
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return &neighbor;
+}
+/*---------------------------------------------------------------------------*/
+
+static const struct {
+  uint16_t handle;
+  uint16_t size;
+  uint16_t links;
+  uint8_t options;
+} slotframes[] = {
+  /* EB slotframe: a single Tx link */
+  { 0, 397, 1, LINK_OPTION_TX },
+  /* Common shared slotframe */
+  { 1, 31, 7, LINK_OPTION_RX | LINK_OPTION_TX | LINK_OPTION_SHARED },
+  /* Receiver-based unicast slotframe, one Tx link per neighbor */
+  { 2, 101, 60, LINK_OPTION_TX | LINK_OPTION_SHARED },
+  /* Sender-based unicast slotframe, one Rx link per neighbor */
+  { 3, 127, 60, LINK_OPTION_RX },
+};
+/*---------------------------------------------------------------------------*/
+/* Reference implementation: scan all links of all slotframes */
+static struct tsch_link *
+linear_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
+                        struct tsch_link **backup_link)
+{
+  uint16_t time_to_curr_best = 0;
+  struct tsch_link *curr_best = NULL;
+  struct tsch_link *curr_backup = NULL;
+  struct tsch_slotframe *sf;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    struct tsch_link *l;
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot =
+        l->timeslot > timeslot ?
+        l->timeslot - timeslot :
+        sf->size.val + l->timeslot - timeslot;
+      if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
+        time_to_curr_best = time_to_timeslot;
+        curr_best = l;
+        curr_backup = NULL;
+      } else if(time_to_timeslot == time_to_curr_best) {
+        struct tsch_link *new_best = NULL;
+        if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+          if(l->slotframe_handle < curr_best->slotframe_handle) {
+            new_best = l;
+          }
+        } else if(l->link_options & LINK_OPTION_TX) {
+          new_best = l;
+        }
+        if(curr_backup == NULL) {
+          if(new_best != l && (l->link_options & LINK_OPTION_RX)) {
+            curr_backup = l;
+          }
+          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) {
+            curr_backup = curr_best;
+          }
+        }
+        if(new_best != NULL) {
+          curr_best = new_best;
+        }
+      }
+    }
+  }
+  *time_offset = time_to_curr_best;
+  *backup_link = curr_backup;
+  return curr_best;
+}
+/*---------------------------------------------------------------------------*/
+static void
+setup_schedule(void)
+{
+  linkaddr_t addr;
+  int i, j;
+
+  tsch_schedule_remove_all_slotframes();
+  for(i = 0; i < sizeof(slotframes) / sizeof(slotframes[0]); i++) {
+    struct tsch_slotframe *sf;
+    sf = tsch_schedule_add_slotframe(slotframes[i].handle, slotframes[i].size);
+    for(j = 0; j < slotframes[i].links; j++) {
+      linkaddr_copy(&addr, &linkaddr_null);
+      addr.u8[LINKADDR_SIZE - 1] = j + 1;
+      /* Spread links over the slotframe, overlapping across slotframes */
+      tsch_schedule_add_link(sf, slotframes[i].options, LINK_TYPE_NORMAL,
+                             &addr, (j * 37 + i) % slotframes[i].size, j % 16);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_links(void)
+{
+  struct tsch_slotframe *sf;
+  int count = 0;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    count += list_length(sf->links_list);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+typedef struct tsch_link *(*next_link_fn)(struct tsch_asn_t *, uint16_t *,
+                                          struct tsch_link **);
+static unsigned long
+run(next_link_fn next_link)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *backup;
+  uint16_t time_offset;
+  unsigned long i;
+  clock_time_t start;
+
+  TSCH_ASN_INIT(asn, 0, 0);
+  start = clock_time();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    next_link(&asn, &time_offset, &backup);
+    /* Move on to the selected link, as the slot operation does */
+    TSCH_ASN_INC(asn, time_offset);
+  }
+  return (unsigned long)(clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_schedule_process, ev, data)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *l1, *l2, *b1, *b2;
+  uint16_t t1, t2;
+  unsigned long ticks;
+  int mismatches;
+  int i;
+
+  PROCESS_BEGIN();
+
+  tsch_schedule_init();
+  setup_schedule();
+
+  mismatches = 0;
+  TSCH_ASN_INIT(asn, 0, 0);
+  for(i = 0; i < 100000; i++) {
+    l1 = tsch_schedule_get_next_active_link(&asn, &t1, &b1);
+    l2 = linear_next_active_link(&asn, &t2, &b2);
+    if(l1 != l2 || t1 != t2 || b1 != b2) {
+      mismatches++;
+    }
+    TSCH_ASN_INC(asn, 1);
+  }
+  printf("Links: %d (index %s)\n", count_links(),
+         TSCH_SCHEDULE_WITH_LINK_INDEX ? "enabled" : "disabled");
+  printf("Mismatching lookups: %d\n", mismatches);
+
+  ticks = run(linear_next_active_link);
+  printf("Linear scan:                        %lu lookups in %lu ticks (%lu ticks/s)\n",
+         NUM_LOOKUPS, ticks, (unsigned long)CLOCK_SECOND);
+  ticks = run(tsch_schedule_get_next_active_link);
+  printf("tsch_schedule_get_next_active_link: %lu lookups in %lu ticks (%lu ticks/s)\n",
+         NUM_LOOKUPS, ticks, (unsigned long)CLOCK_SECOND);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
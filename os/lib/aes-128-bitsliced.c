@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Bitsliced AES-128. The state is held as eight 16-bit planes,
+ *         plane b holding bit b of each of the 16 bytes, and the S-box
+ *         is computed with the logic circuit of Boyar and Peralta.
+ *         There is no data-dependent table lookup or branch, so the
+ *         timing does not depend on the key or on the data.
+ *
+ *         The key schedules of the last AES_128_KEY_CACHE_SIZE keys
+ *         are kept in bitsliced form. Keys are compared with the cache
+ *         in constant time; only whether a key is cached shows in the
+ *         timing of set_key.
+ */
+
+#include "lib/aes-128.h"
+#include <string.h>
+
+struct key_schedule {
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint16_t round_keys[11][8];
+};
+
+static struct key_schedule schedules[AES_128_KEY_CACHE_SIZE];
+static uint8_t schedules_used;
+static uint8_t schedules_next;
+static const struct key_schedule *current = &schedules[0];
+/*---------------------------------------------------------------------------*/
+/* Byte i of the state is bit i of each plane */
+static void
+to_planes(uint16_t *q, const uint8_t *bytes, uint8_t len)
+{
+  uint8_t b;
+  uint8_t i;
+
+  for(b = 0; b < 8; b++) {
+    q[b] = 0;
+    for(i = 0; i < len; i++) {
+      q[b] |= (uint16_t)((bytes[i] >> b) & 1) << i;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+from_planes(uint8_t *bytes, const uint16_t *q, uint8_t len)
+{
+  uint8_t b;
+  uint8_t i;
+
+  for(i = 0; i < len; i++) {
+    bytes[i] = 0;
+    for(b = 0; b < 8; b++) {
+      bytes[i] |= ((q[b] >> i) & 1) << b;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sub_bytes(uint16_t *q)
+{
+  uint16_t x0, x1, x2, x3, x4, x5, x6, x7;
+  uint16_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11;
+  uint16_t y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+  uint16_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11;
+  uint16_t z12, z13, z14, z15, z16, z17;
+  uint16_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12;
+  uint16_t t13, t14, t15, t16, t17, t18, t19, t20, t21, t22, t23;
+  uint16_t t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34;
+  uint16_t t35, t36, t37, t38, t39, t40, t41, t42, t43, t44, t45;
+  uint16_t t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56;
+  uint16_t t57, t58, t59, t60, t61, t62, t63, t64, t65, t66, t67;
+  uint16_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  /* The circuit numbers bits from the most significant one */
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation */
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9 = x0 ^ x3;
+  y8 = x0 ^ x5;
+  t0 = x1 ^ x2;
+  y1 = t0 ^ x7;
+  y4 = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2 = y1 ^ x0;
+  y5 = y1 ^ x6;
+  y3 = y5 ^ y8;
+  t1 = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6 = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7 = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non-linear part: inversion in GF(2^8) */
+  t2 = y12 & y15;
+  t3 = y3 & y6;
+  t4 = t3 ^ t2;
+  t5 = y4 & x7;
+  t6 = t5 ^ t2;
+  t7 = y13 & y16;
+  t8 = y5 & y1;
+  t9 = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0 = t44 & y15;
+  z1 = t37 & y6;
+  z2 = t33 & x7;
+  z3 = t43 & y16;
+  z4 = t40 & y1;
+  z5 = t29 & y7;
+  z6 = t42 & y11;
+  z7 = t45 & y17;
+  z8 = t41 & y10;
+  z9 = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation */
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0 = t59 ^ t63;
+  s6 = t56 ^ ~t62;
+  s7 = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3 = t53 ^ t66;
+  s4 = t51 ^ t66;
+  s5 = t47 ^ t65;
+  s1 = t64 ^ ~s3;
+  s2 = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+}
+/*---------------------------------------------------------------------------*/
+#define ROTR16(x, n) ((uint16_t)(((x) >> (n)) | ((x) << (16 - (n)))))
+/*---------------------------------------------------------------------------*/
+/* Byte 4c + r is in row r of column c. Row r rotates left by r columns. */
+static void
+shift_rows(uint16_t *q)
+{
+  uint8_t b;
+
+  for(b = 0; b < 8; b++) {
+    q[b] = (q[b] & 0x1111) | (ROTR16(q[b], 4) & 0x2222)
+        | (ROTR16(q[b], 8) & 0x4444) | (ROTR16(q[b], 12) & 0x8888);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Moves row r + n of each column to row r */
+#define ROWS1(x) ((uint16_t)((((x) >> 1) & 0x7777) | (((x) << 3) & 0x8888)))
+#define ROWS2(x) ((uint16_t)((((x) >> 2) & 0x3333) | (((x) << 2) & 0xcccc)))
+#define ROWS3(x) ((uint16_t)((((x) >> 3) & 0x1111) | (((x) << 1) & 0xeeee)))
+/*---------------------------------------------------------------------------*/
+static void
+mix_columns(uint16_t *q)
+{
+  uint16_t a[8];
+  uint16_t r1;
+  uint8_t b;
+
+  /* b_r = 2 * (a_r + a_r+1) + a_r+1 + a_r+2 + a_r+3 */
+  for(b = 0; b < 8; b++) {
+    r1 = ROWS1(q[b]);
+    a[b] = q[b] ^ r1;
+    q[b] = r1 ^ ROWS2(q[b]) ^ ROWS3(q[b]);
+  }
+
+  /* Multiplication of a by 2, modulo x^8 + x^4 + x^3 + x + 1 */
+  q[0] ^= a[7];
+  q[1] ^= a[0] ^ a[7];
+  q[2] ^= a[1];
+  q[3] ^= a[2] ^ a[7];
+  q[4] ^= a[3] ^ a[7];
+  q[5] ^= a[4];
+  q[6] ^= a[5];
+  q[7] ^= a[6];
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_round_key(uint16_t *q, const uint16_t *rk)
+{
+  uint8_t b;
+
+  for(b = 0; b < 8; b++) {
+    q[b] ^= rk[b];
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(struct key_schedule *ks)
+{
+  uint8_t rk[AES_128_KEY_LENGTH];
+  uint8_t t[4];
+  uint16_t q[8];
+  uint8_t rcon;
+  uint8_t round;
+  uint8_t i;
+
+  memcpy(rk, ks->key, AES_128_KEY_LENGTH);
+  to_planes(ks->round_keys[0], rk, AES_128_KEY_LENGTH);
+  rcon = 0x01;
+  for(round = 1; round <= 10; round++) {
+    /* RotWord and SubWord, through the bitsliced S-box as well */
+    t[0] = rk[13];
+    t[1] = rk[14];
+    t[2] = rk[15];
+    t[3] = rk[12];
+    to_planes(q, t, 4);
+    sub_bytes(q);
+    from_planes(t, q, 4);
+
+    rk[0] ^= t[0] ^ rcon;
+    rk[1] ^= t[1];
+    rk[2] ^= t[2];
+    rk[3] ^= t[3];
+    for(i = 4; i < AES_128_KEY_LENGTH; i++) {
+      rk[i] ^= rk[i - 4];
+    }
+    to_planes(ks->round_keys[round], rk, AES_128_KEY_LENGTH);
+    rcon = (rcon << 1) ^ ((rcon >> 7) * 0x1b);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Compare two keys without stopping at the first differing byte. */
+static int
+key_equal(const uint8_t *a, const uint8_t *b)
+{
+  uint8_t diff;
+  uint8_t i;
+
+  diff = 0;
+  for(i = 0; i < AES_128_KEY_LENGTH; i++) {
+    diff |= a[i] ^ b[i];
+  }
+  return diff == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  struct key_schedule *ks;
+  uint8_t i;
+
+  /* Compare with every cached key, so that the time taken does not
+     depend on which of them matches. */
+  ks = NULL;
+  for(i = 0; i < schedules_used; i++) {
+    if(key_equal(schedules[i].key, key)) {
+      ks = &schedules[i];
+    }
+  }
+  if(ks != NULL) {
+    current = ks;
+    return;
+  }
+
+  /* Not cached, replace the oldest schedule */
+  ks = &schedules[schedules_next];
+  schedules_next = (schedules_next + 1) % AES_128_KEY_CACHE_SIZE;
+  if(schedules_used < AES_128_KEY_CACHE_SIZE) {
+    schedules_used++;
+  }
+  memcpy(ks->key, key, AES_128_KEY_LENGTH);
+  expand_key(ks);
+  current = ks;
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *state)
+{
+  uint16_t q[8];
+  uint8_t round;
+
+  to_planes(q, state, AES_128_BLOCK_SIZE);
+  add_round_key(q, current->round_keys[0]);
+  for(round = 1; round <= 10; round++) {
+    sub_bytes(q);
+    shift_rows(q);
+    /* Last round skips MixColumns */
+    if(round < 10) {
+      mix_columns(q);
+    }
+    add_round_key(q, current->round_keys[round]);
+  }
+  from_planes(state, q, AES_128_BLOCK_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver aes_128_bitsliced_driver = {
+  set_key,
+  encrypt
+};
+/*---------------------------------------------------------------------------*/
@@ -51,6 +51,17 @@
 #define AES_128            aes_128_driver
 #endif /* AES_128_CONF */
 
+/*
+ * Number of expanded key schedules kept by aes_128_ttable_driver and
+ * aes_128_bitsliced_driver. Setting a key that is in the cache skips
+ * the key expansion. TSCH, for instance, alternates between two keys.
+ */
+#ifdef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_KEY_CACHE_SIZE AES_128_CONF_KEY_CACHE_SIZE
+#else /* AES_128_CONF_KEY_CACHE_SIZE */
+#define AES_128_KEY_CACHE_SIZE 2
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+
 /**
  * Structure of AES drivers.
  */
@@ -69,4 +80,23 @@ struct aes_128_driver {
 
 extern const struct aes_128_driver AES_128;
 
+/**
+ * Reference software AES-128, the default driver. Small, but slow.
+ */
+extern const struct aes_128_driver aes_128_driver;
+
+/**
+ * Software AES-128 using 32-bit lookup tables (1 kbyte of tables).
+ * Faster than aes_128_driver, but its table lookups depend on the
+ * data, so its timing is not constant on cached CPUs.
+ */
+extern const struct aes_128_driver aes_128_ttable_driver;
+
+/**
+ * Bitsliced software AES-128, without any data-dependent table lookup
+ * or branch, and thus constant-time, except that setting a key whose
+ * schedule is cached is faster. Slower than the table-based drivers.
+ */
+extern const struct aes_128_driver aes_128_bitsliced_driver;
+
 #endif /* AES_128_H_ */
@@ -55,6 +55,25 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki.h"
+
+/**
+ * \brief Selects how the checksum is computed.
+ *
+ *        - 0: bit-serial, without any table. This is the default, since
+ *          it is the smallest.
+ *        - 1: one lookup per byte in a 256-entry table (512 bytes).
+ *        - 4 or 8: slice-by-4 or slice-by-8. crc16_data() processes 4 or
+ *          8 bytes per step with 4 or 8 tables (2 or 4 kbytes).
+ *
+ *        The tables are constant data, placed in flash on most targets.
+ */
+#ifdef CRC16_CONF_TABLE_SLICES
+#define CRC16_TABLE_SLICES CRC16_CONF_TABLE_SLICES
+#else
+#define CRC16_TABLE_SLICES 0
+#endif
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,10 +84,10 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Unless CRC16_TABLE_SLICES is set, the algorithm
+ *             used in this implementation is tailored for a running
+ *             checksum and does not perform as well as a table-driven
+ *             algorithm when checksumming an entire data block.
  *
  */
 unsigned short crc16_add(unsigned char b, unsigned short crc);
@@ -82,10 +101,10 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Unless CRC16_TABLE_SLICES is set, the algorithm
+ *             used in this implementation is tailored for a running
+ *             checksum and does not perform as well as a table-driven
+ *             algorithm when checksumming an entire data block.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
@@ -119,6 +119,10 @@
 
 /* Macros for determining the status of a chunk. */
 #define CHUNK_FLAG_ALLOCATED		0x1
+/* Chunks belonging to a size class are always marked as allocated
+   for the general-purpose allocator, so they are never coalesced. */
+#define CHUNK_FLAG_CLASS		0x2
+#define CHUNK_FLAG_CLASS_FREE		0x4
 
 #define CHUNK_ALLOCATED(chunk)			\
   ((chunk)->flags & CHUNK_FLAG_ALLOCATED)
@@ -149,6 +153,17 @@ static size_t heap_usage;
 static chunk_t *first_chunk = (chunk_t *)heap_base;
 static chunk_t *free_list;
 
+#if HEAPMEM_SIZE_CLASSES
+#define CLASS_STEP ALIGN(HEAPMEM_SIZE_CLASS_STEP)
+#define CLASS_SIZE(index) (((index) + 1) * CLASS_STEP)
+#define CLASS_MAX_SIZE CLASS_SIZE(HEAPMEM_SIZE_CLASSES - 1)
+/* The smallest class whose chunks can hold size bytes. */
+#define CLASS_FOR_SIZE(size) ((size) == 0 ? 0 : ((size) - 1) / CLASS_STEP)
+
+/* Single-linked free lists of the size classes. */
+static chunk_t *class_free_lists[HEAPMEM_SIZE_CLASSES];
+#endif /* HEAPMEM_SIZE_CLASSES */
+
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
 static void *
@@ -306,6 +321,104 @@ get_free_chunk(const size_t size)
   return best;
 }
 
+#if HEAPMEM_SIZE_CLASSES
+/* chunk_class: Get the largest class that a chunk is big enough for. */
+static int
+chunk_class(const chunk_t *chunk)
+{
+  size_t index;
+
+  index = chunk->size / CLASS_STEP - 1;
+  return index < HEAPMEM_SIZE_CLASSES ? index : HEAPMEM_SIZE_CLASSES - 1;
+}
+
+/* put_class_chunk: Put a chunk on the free list of its size class. */
+static void
+put_class_chunk(chunk_t * const chunk)
+{
+  int index;
+
+  index = chunk_class(chunk);
+  chunk->flags |= CHUNK_FLAG_CLASS_FREE;
+  chunk->next = class_free_lists[index];
+  class_free_lists[index] = chunk;
+}
+
+/* release_class_chunks: Give all chunks on the free lists of the size
+   classes back to the general-purpose allocator. Returns the number
+   of released chunks. */
+static int
+release_class_chunks(void)
+{
+  int i;
+  int released;
+  chunk_t *chunk;
+
+  released = 0;
+  for(i = 0; i < HEAPMEM_SIZE_CLASSES; i++) {
+    while(class_free_lists[i] != NULL) {
+      chunk = class_free_lists[i];
+      class_free_lists[i] = chunk->next;
+      chunk->flags = 0;
+      free_chunk(chunk);
+      released++;
+    }
+  }
+  return released;
+}
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+/* get_heap_chunk: Allocate a chunk with the general-purpose allocator,
+   by reusing a free chunk or by extending the heap space. */
+static chunk_t *
+get_heap_chunk(const size_t size)
+{
+  chunk_t *chunk;
+
+  chunk = get_free_chunk(size);
+  if(chunk == NULL) {
+    chunk = extend_space(sizeof(chunk_t) + size);
+    if(chunk == NULL) {
+#if HEAPMEM_SIZE_CLASSES
+      /* Make the memory kept by the size classes available and retry. */
+      if(release_class_chunks() > 0) {
+        return get_heap_chunk(size);
+      }
+#endif /* HEAPMEM_SIZE_CLASSES */
+      return NULL;
+    }
+    chunk->size = size;
+  }
+
+  chunk->flags = CHUNK_FLAG_ALLOCATED;
+  return chunk;
+}
+
+#if HEAPMEM_SIZE_CLASSES
+/* get_class_chunk: Allocate a chunk from the free list of the smallest
+   size class that fits, or from the heap if the free list is empty. */
+static chunk_t *
+get_class_chunk(const size_t size)
+{
+  int index;
+  chunk_t *chunk;
+
+  index = CLASS_FOR_SIZE(size);
+  chunk = class_free_lists[index];
+  if(chunk != NULL) {
+    class_free_lists[index] = chunk->next;
+  } else {
+    chunk = get_heap_chunk(CLASS_SIZE(index));
+    if(chunk == NULL) {
+      return NULL;
+    }
+  }
+
+  chunk->flags = CHUNK_FLAG_ALLOCATED | CHUNK_FLAG_CLASS;
+  return chunk;
+}
+#endif /* HEAPMEM_SIZE_CLASSES */
+
 /*
  * heapmem_alloc: Allocate an object of the specified size, returning
  * a pointer to it in case of success, and NULL in case of failure.
@@ -319,6 +432,9 @@ get_free_chunk(const size_t size)
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
+ *
+ * With HEAPMEM_CONF_SIZE_CLASSES, small objects are instead taken
+ * from the free list of their size class when it is not empty.
  */
 void *
 #if HEAPMEM_DEBUG
@@ -331,17 +447,19 @@ heapmem_alloc(size_t size)
 
   size = ALIGN(size);
 
-  chunk = get_free_chunk(size);
+#if HEAPMEM_SIZE_CLASSES
+  if(size <= CLASS_MAX_SIZE) {
+    chunk = get_class_chunk(size);
+  } else {
+    chunk = get_heap_chunk(size);
+  }
+#else /* HEAPMEM_SIZE_CLASSES */
+  chunk = get_heap_chunk(size);
+#endif /* HEAPMEM_SIZE_CLASSES */
   if(chunk == NULL) {
-    chunk = extend_space(sizeof(chunk_t) + size);
-    if(chunk == NULL) {
-      return NULL;
-    }
-    chunk->size = size;
+    return NULL;
   }
 
-  chunk->flags = CHUNK_FLAG_ALLOCATED;
-
 #if HEAPMEM_DEBUG
   chunk->file = file;
   chunk->line = line;
@@ -379,6 +497,12 @@ heapmem_free(void *ptr)
     PRINTF("%s ptr %p, allocated at %s:%u\n", __func__, ptr,
            chunk->file, chunk->line);
 
+#if HEAPMEM_SIZE_CLASSES
+    if(chunk->flags & CHUNK_FLAG_CLASS) {
+      put_class_chunk(chunk);
+      return;
+    }
+#endif /* HEAPMEM_SIZE_CLASSES */
     free_chunk(chunk);
   }
 }
@@ -430,6 +554,23 @@ heapmem_realloc(void *ptr, size_t size)
 #endif
 
   size = ALIGN(size);
+
+#if HEAPMEM_SIZE_CLASSES
+  if(chunk->flags & CHUNK_FLAG_CLASS) {
+    /* Chunks of a size class keep their size, so move the object
+       unless it still fits. */
+    if(size <= chunk->size) {
+      return ptr;
+    }
+    newptr = heapmem_alloc(size);
+    if(newptr != NULL) {
+      memcpy(newptr, ptr, chunk->size);
+      heapmem_free(ptr);
+    }
+    return newptr;
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
+
   size_adj = size - chunk->size;
 
   if(size_adj <= 0) {
@@ -488,12 +629,34 @@ void
 heapmem_stats(heapmem_stats_t *stats)
 {
   chunk_t *chunk;
+#if HEAPMEM_SIZE_CLASSES
+  int i;
+#endif /* HEAPMEM_SIZE_CLASSES */
 
   memset(stats, 0, sizeof(*stats));
+#if HEAPMEM_SIZE_CLASSES
+  for(i = 0; i < HEAPMEM_SIZE_CLASSES; i++) {
+    stats->classes[i].size = CLASS_SIZE(i);
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
 
   for(chunk = first_chunk;
       (char *)chunk < &heap_base[heap_usage];
       chunk = NEXT_CHUNK(chunk)) {
+#if HEAPMEM_SIZE_CLASSES
+    if(chunk->flags & CHUNK_FLAG_CLASS) {
+      i = chunk_class(chunk);
+      if(chunk->flags & CHUNK_FLAG_CLASS_FREE) {
+        stats->classes[i].free++;
+        stats->available += chunk->size;
+      } else {
+        stats->classes[i].allocated++;
+        stats->allocated += chunk->size;
+      }
+      stats->overhead += sizeof(chunk_t);
+      continue;
+    }
+#endif /* HEAPMEM_SIZE_CLASSES */
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
     } else {
@@ -74,14 +74,48 @@
 #ifndef HEAPMEM_H
 #define HEAPMEM_H
 
+#include "contiki.h"
+
 #include <stdlib.h>
 
+/*
+ * The HEAPMEM_CONF_SIZE_CLASSES parameter enables segregated free lists
+ * for small objects when set to a non-zero value. Each of the size
+ * classes holds chunks of HEAPMEM_CONF_SIZE_CLASS_STEP bytes more than
+ * the previous one. Allocations up to the size of the largest class
+ * are served from the free list of the smallest class that fits, in
+ * constant time. A freed chunk is returned to the free list of its
+ * class, and the free lists are only given back to the heap when an
+ * allocation would fail otherwise. Larger allocations use the
+ * general-purpose allocator.
+ */
+#ifdef HEAPMEM_CONF_SIZE_CLASSES
+#define HEAPMEM_SIZE_CLASSES HEAPMEM_CONF_SIZE_CLASSES
+#else
+#define HEAPMEM_SIZE_CLASSES 0
+#endif /* HEAPMEM_CONF_SIZE_CLASSES */
+
+#ifdef HEAPMEM_CONF_SIZE_CLASS_STEP
+#define HEAPMEM_SIZE_CLASS_STEP HEAPMEM_CONF_SIZE_CLASS_STEP
+#else
+#define HEAPMEM_SIZE_CLASS_STEP 16
+#endif /* HEAPMEM_CONF_SIZE_CLASS_STEP */
+
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
   size_t available;
   size_t footprint;
   size_t chunks;
+#if HEAPMEM_SIZE_CLASSES
+  /* Occupancy of each size class. Free chunks of a class are also
+     counted as available. */
+  struct {
+    size_t size;
+    size_t allocated;
+    size_t free;
+  } classes[HEAPMEM_SIZE_CLASSES];
+#endif /* HEAPMEM_SIZE_CLASSES */
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
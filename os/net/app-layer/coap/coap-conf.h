@@ -83,6 +83,34 @@
 #define COAP_MAX_OPEN_TRANSACTIONS     4
 #endif /* COAP_MAX_OPEN_TRANSACTIONS */
 
+/*
+ * Number of buckets of the hash table that indexes the open transactions
+ * by MID. With 0, the transactions are searched in turn.
+ */
+#ifndef COAP_TRANSACTION_HASH_SIZE
+#define COAP_TRANSACTION_HASH_SIZE     0
+#endif /* COAP_TRANSACTION_HASH_SIZE */
+
+/*
+ * Congestion control of confirmable messages, as in CoCoA: keep a
+ * round-trip time estimate for each of the last COAP_MAX_PEERS endpoints
+ * to set the retransmission timeouts, and send at most COAP_NSTART
+ * confirmable messages at a time to an endpoint, queuing the others. A
+ * notification to an observer can also replace the pending confirmable
+ * notification to the same observer when no transaction is free.
+ */
+#ifndef COAP_CONGESTION_CONTROL
+#define COAP_CONGESTION_CONTROL        0
+#endif /* COAP_CONGESTION_CONTROL */
+
+#ifndef COAP_NSTART
+#define COAP_NSTART                    1
+#endif /* COAP_NSTART */
+
+#ifndef COAP_MAX_PEERS
+#define COAP_MAX_PEERS                 COAP_MAX_OPEN_TRANSACTIONS
+#endif /* COAP_MAX_PEERS */
+
 /* Maximum number of failed request attempts before action */
 #ifndef COAP_MAX_ATTEMPTS
 #define COAP_MAX_ATTEMPTS              4
@@ -93,6 +121,15 @@
 #define COAP_MAX_HEADER_SIZE           (4 + COAP_TOKEN_LEN + 3 + 1 + COAP_ETAG_LEN + 4 + 4 + 30)  /* 65 */
 #endif /* COAP_MAX_HEADER_SIZE */
 
+/*
+ * Number of buckets of the hash table that indexes the activated
+ * resources by URI path. With 0, each request is matched against the
+ * URI paths of all resources in turn.
+ */
+#ifndef COAP_RESOURCE_HASH_SIZE
+#define COAP_RESOURCE_HASH_SIZE        0
+#endif /* COAP_RESOURCE_HASH_SIZE */
+
 /* Number of observer slots (each takes abot xxx bytes) */
 #ifndef COAP_MAX_OBSERVERS
 #define COAP_MAX_OBSERVERS    COAP_MAX_OPEN_TRANSACTIONS - 1
@@ -103,5 +140,14 @@
 #define COAP_OBSERVE_REFRESH_INTERVAL  20
 #endif /* COAP_OBSERVE_REFRESH_INTERVAL */
 
+/*
+ * Render each notification only once and copy it to the transaction of
+ * every observer, patching the token, MID, type and Observe option,
+ * instead of calling the resource handler once per observer.
+ */
+#ifndef COAP_OBSERVE_RENDER_ONCE
+#define COAP_OBSERVE_RENDER_ONCE       0
+#endif /* COAP_OBSERVE_RENDER_ONCE */
+
 #endif /* COAP_CONF_H_ */
 /** @} */
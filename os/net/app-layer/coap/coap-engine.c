@@ -72,6 +72,17 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+#if COAP_RESOURCE_HASH_SIZE
+/* The activated resources, hashed by URL. */
+static coap_resource_t *resource_index[COAP_RESOURCE_HASH_SIZE];
+static uint16_t resource_order;
+
+/* djb2, which can be computed incrementally over the segments of a
+   URI path. */
+#define URL_HASH_INIT 5381
+#define URL_HASH_ADD(hash, c) ((uint16_t)(((hash) << 5) + (hash) + (uint8_t)(c)))
+#endif /* COAP_RESOURCE_HASH_SIZE */
+
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -312,7 +323,7 @@ coap_receive(const coap_endpoint_t *src,
         coap_resource_response_handler_t callback = transaction->callback;
         void *callback_data = transaction->callback_data;
 
-        coap_clear_transaction(transaction);
+        coap_complete_transaction(transaction);
 
         /* check if someone registered for the response */
         if(callback) {
@@ -379,6 +390,9 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_HASH_SIZE
+  memset(resource_index, 0, sizeof(resource_index));
+#endif /* COAP_RESOURCE_HASH_SIZE */
 
   coap_activate_resource(&res_well_known_core, ".well-known/core");
 
@@ -386,6 +400,47 @@ coap_engine_init(void)
   coap_init_connection();
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_RESOURCE_HASH_SIZE
+static uint16_t
+url_hash(const char *url, int url_len)
+{
+  uint16_t hash;
+  int i;
+
+  hash = URL_HASH_INIT;
+  for(i = 0; i < url_len; i++) {
+    hash = URL_HASH_ADD(hash, url[i]);
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_resource(coap_resource_t *resource, const char *path)
+{
+  coap_resource_t **r;
+
+  /* Remove the resource if it was activated before. */
+  if(resource->url != NULL) {
+    r = &resource_index[url_hash(resource->url, resource->url_len) %
+                        COAP_RESOURCE_HASH_SIZE];
+    for(; *r != NULL; r = &(*r)->hash_next) {
+      if(*r == resource) {
+        *r = resource->hash_next;
+        break;
+      }
+    }
+  }
+
+  /* list_add() moves the resource to the end of the list. */
+  resource->order = resource_order++;
+  resource->url_len = strlen(path);
+  r = &resource_index[url_hash(path, resource->url_len) %
+                      COAP_RESOURCE_HASH_SIZE];
+  resource->hash_next = *r;
+  *r = resource;
+}
+#endif /* COAP_RESOURCE_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
  * \param resource A pointer to a resource implementation
@@ -399,6 +454,9 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+#if COAP_RESOURCE_HASH_SIZE
+  index_resource(resource, path);
+#endif /* COAP_RESOURCE_HASH_SIZE */
   resource->url = path;
   list_add(coap_resource_services, resource);
 
@@ -432,19 +490,40 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
-static int
-invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
-                             uint8_t *buffer, uint16_t buffer_size,
-                             int32_t *offset)
+coap_resource_t *
+coap_find_resource(const char *url, int url_len)
 {
-  uint8_t found = 0;
-  uint8_t allowed = 1;
-
-  coap_resource_t *resource = NULL;
-  const char *url = NULL;
-  int url_len, res_url_len;
+  coap_resource_t *resource;
+#if COAP_RESOURCE_HASH_SIZE
+  coap_resource_t *found = NULL;
+  uint16_t hash;
+  int i;
+
+  /* Look up the whole URI path, and each prefix that ends before a
+     slash for resources with sub-resources. Among all matches, the
+     first activated resource wins, as with a walk through the list. */
+  hash = URL_HASH_INIT;
+  for(i = 0; i <= url_len; i++) {
+    if(i == url_len || url[i] == '/') {
+      for(resource = resource_index[hash % COAP_RESOURCE_HASH_SIZE];
+          resource != NULL; resource = resource->hash_next) {
+        if(resource->url_len == i
+           && (i == url_len || (resource->flags & HAS_SUB_RESOURCES))
+           && memcmp(resource->url, url, i) == 0
+           && (found == NULL
+               || (int16_t)(resource->order - found->order) < 0)) {
+          found = resource;
+        }
+      }
+    }
+    if(i < url_len) {
+      hash = URL_HASH_ADD(hash, url[i]);
+    }
+  }
+  return found;
+#else /* COAP_RESOURCE_HASH_SIZE */
+  int res_url_len;
 
-  url_len = coap_get_header_uri_path(request, &url);
   for(resource = list_head(coap_resource_services);
       resource; resource = resource->next) {
 
@@ -455,31 +534,51 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
             && (resource->flags & HAS_SUB_RESOURCES)
             && url[res_url_len] == '/'))
        && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+      return resource;
+    }
+  }
+  return NULL;
+#endif /* COAP_RESOURCE_HASH_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+static int
+invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
+                             uint8_t *buffer, uint16_t buffer_size,
+                             int32_t *offset)
+{
+  uint8_t found = 0;
+  uint8_t allowed = 1;
+
+  coap_resource_t *resource = NULL;
+  const char *url = NULL;
+  int url_len;
+
+  url_len = coap_get_header_uri_path(request, &url);
+  resource = coap_find_resource(url, url_len);
+  if(resource != NULL) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
@@ -111,6 +111,11 @@ struct coap_resource_s {
     coap_resource_trigger_handler_t trigger;
     coap_resource_trigger_handler_t resume;
   };
+#if COAP_RESOURCE_HASH_SIZE
+  coap_resource_t *hash_next;       /* next resource in the same bucket */
+  uint16_t url_len;                 /* length of the URL */
+  uint16_t order;                   /* position in the list of resources */
+#endif /* COAP_RESOURCE_HASH_SIZE */
 };
 
 struct coap_periodic_resource_s {
@@ -167,6 +172,16 @@ coap_resource_t *coap_get_first_resource(void);
  */
 coap_resource_t *coap_get_next_resource(coap_resource_t *resource);
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Finds the resource that handles a URI path.
+ * \param url  The URI path, without leading slash.
+ * \param url_len The length of the URI path.
+ * \return     The first activated resource whose URL is the URI path,
+ *             or a prefix of it if the resource has sub-resources, or
+ *             NULL if no resource matches.
+ */
+coap_resource_t *coap_find_resource(const char *url, int url_len);
+/*---------------------------------------------------------------------------*/
 
 #include "coap-transactions.h"
 #include "coap-observe.h"
@@ -56,6 +56,16 @@
 /*---------------------------------------------------------------------------*/
 MEMB(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
 LIST(observers_list);
+
+#if COAP_OBSERVE_RENDER_ONCE
+/* The notification being sent to all observers, serialized without a
+   token. */
+static uint8_t notification_buffer[COAP_MAX_PACKET_SIZE + 1];
+static uint16_t notification_len;
+/* The offset of the value of the Observe option in the notification,
+   or 0 if the notification has no Observe option. */
+static uint16_t observe_offset;
+#endif /* COAP_OBSERVE_RENDER_ONCE */
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -75,6 +85,7 @@ add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
     }
     memcpy(o->url, uri, max);
     o->url[max] = 0;
+    o->url_len = max;
     coap_endpoint_copy(&o->endpoint, endpoint);
     o->token_len = token_len;
     memcpy(o->token, token, token_len);
@@ -152,7 +163,7 @@ coap_remove_observer_by_uri(const coap_endpoint_t *endpoint,
     LOG_DBG("Remove check URL %p\n", uri);
     if((endpoint == NULL
         || (coap_endpoint_cmp(&obs->endpoint, endpoint)))
-       && (obs->url == uri || memcmp(obs->url, uri, strlen(obs->url)) == 0)) {
+       && (obs->url == uri || memcmp(obs->url, uri, obs->url_len) == 0)) {
       coap_remove_observer(obs);
       removed++;
     }
@@ -180,6 +191,182 @@ coap_remove_observer_by_mid(const coap_endpoint_t *endpoint, uint16_t mid)
 /*---------------------------------------------------------------------------*/
 /*- Notification ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
+static void
+call_notification_handler(coap_resource_t *resource, coap_message_t *request,
+                          coap_message_t *notification, uint8_t *buffer,
+                          int32_t *new_offset)
+{
+  /* Either old style get_handler or the full handler */
+  if(coap_call_handlers(request, notification, buffer + COAP_MAX_HEADER_SIZE,
+                        COAP_MAX_CHUNK_SIZE, new_offset) > 0) {
+    LOG_DBG("Notification on new handlers\n");
+  } else {
+    if(resource != NULL) {
+      resource->get_handler(request, notification,
+                            buffer + COAP_MAX_HEADER_SIZE,
+                            COAP_MAX_CHUNK_SIZE, new_offset);
+    } else {
+      /* What to do here? */
+      notification->code = BAD_REQUEST_4_00;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Get a transaction for a notification to an observer. With congestion
+   control, when no transaction is free, take over the pending
+   confirmable notification to the observer instead, and set replaced:
+   the new notification must then be confirmable, and is sent in place
+   of the pending one. */
+static coap_transaction_t *
+new_notification_transaction(coap_observer_t *obs, uint8_t *replaced)
+{
+  coap_transaction_t *transaction;
+  uint16_t mid;
+
+  *replaced = 0;
+  mid = coap_get_mid();
+  transaction = coap_new_transaction(mid, &obs->endpoint);
+#if COAP_CONGESTION_CONTROL
+  if(transaction == NULL) {
+    transaction = coap_replace_transaction(obs->last_mid, &obs->endpoint,
+                                           obs->token, obs->token_len, mid);
+    *replaced = transaction != NULL;
+  }
+#endif /* COAP_CONGESTION_CONTROL */
+  return transaction;
+}
+/*---------------------------------------------------------------------------*/
+#if COAP_OBSERVE_RENDER_ONCE
+/* Find the value of the Observe option in the notification buffer. */
+static uint16_t
+find_observe_value(void)
+{
+  const uint8_t *option;
+  const uint8_t *header;
+  const uint8_t *end;
+  unsigned int number;
+  unsigned int delta;
+  unsigned int len;
+
+  option = notification_buffer + COAP_HEADER_LEN;
+  end = notification_buffer + notification_len;
+  number = 0;
+  while(option < end && *option != 0xFF) {
+    header = option;
+    delta = *option >> 4;
+    len = *option & COAP_HEADER_OPTION_SHORT_LENGTH_MASK;
+    ++option;
+    if(delta == 13) {
+      delta = *option++ + 13;
+    } else if(delta == 14) {
+      delta = ((option[0] << 8) | option[1]) + 269;
+      option += 2;
+    }
+    if(len == 13) {
+      len = *option++ + 13;
+    } else if(len == 14) {
+      len = ((option[0] << 8) | option[1]) + 269;
+      option += 2;
+    }
+    number += delta;
+    if(number == COAP_OPTION_OBSERVE) {
+      /* The placeholder has a one-byte option header. */
+      return len == 3 && option == header + 1 ?
+        option - notification_buffer : 0;
+    }
+    option += len;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Call the resource handler and serialize the notification, without a
+   token, into the shared notification buffer. */
+static void
+render_notification(coap_resource_t *resource, coap_message_t *request,
+                    coap_message_t *notification)
+{
+  int32_t new_offset = 0;
+
+  call_notification_handler(resource, request, notification,
+                            notification_buffer, &new_offset);
+
+  if(notification->code < BAD_REQUEST_4_00) {
+    /* A three-byte placeholder for the value of each observer. */
+    coap_set_header_observe(notification, 0xffffff);
+  }
+
+  if(new_offset != 0) {
+    coap_set_header_block2(notification,
+                           0,
+                           new_offset != -1,
+                           COAP_MAX_BLOCK_SIZE);
+    coap_set_payload(notification,
+                     notification->payload,
+                     MIN(notification->payload_len,
+                         COAP_MAX_BLOCK_SIZE));
+  }
+
+  notification_len = coap_serialize_message(notification,
+                                            notification_buffer);
+  observe_offset = notification->code < BAD_REQUEST_4_00 ?
+    find_observe_value() : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Write the rendered notification for an observer into buffer, and
+   return its length. Advances the observe counter of the observer. */
+static uint16_t
+write_notification(uint8_t *buffer, coap_observer_t *obs,
+                   coap_message_type_t type, uint16_t mid)
+{
+  uint8_t *out;
+  uint32_t value;
+  unsigned int value_len;
+  unsigned int len;
+
+  buffer[0] = (notification_buffer[0] &
+               ~(COAP_HEADER_TYPE_MASK | COAP_HEADER_TOKEN_LEN_MASK)) |
+    (COAP_HEADER_TYPE_MASK & type << COAP_HEADER_TYPE_POSITION) |
+    (COAP_HEADER_TOKEN_LEN_MASK & obs->token_len <<
+     COAP_HEADER_TOKEN_LEN_POSITION);
+  buffer[1] = notification_buffer[1];
+  buffer[2] = (uint8_t)(mid >> 8);
+  buffer[3] = (uint8_t)mid;
+  memcpy(buffer + COAP_HEADER_LEN, obs->token, obs->token_len);
+  out = buffer + COAP_HEADER_LEN + obs->token_len;
+
+  if(observe_offset == 0) {
+    len = notification_len - COAP_HEADER_LEN;
+    memcpy(out, notification_buffer + COAP_HEADER_LEN, len);
+    return out + len - buffer;
+  }
+
+  /* Copy the options up to the Observe option, write its value with as
+     few bytes as coap_serialize_message() would, and copy the rest. The
+     next option is unaffected, as its delta does not depend on the
+     length of the Observe option. */
+  value = obs->obs_counter;
+  value_len = value > 0xffff ? 3 : value > 0xff ? 2 : value > 0 ? 1 : 0;
+  len = observe_offset - 1 - COAP_HEADER_LEN;
+  memcpy(out, notification_buffer + COAP_HEADER_LEN, len);
+  out += len;
+  *out++ = (notification_buffer[observe_offset - 1] &
+            COAP_HEADER_OPTION_DELTA_MASK) | value_len;
+  while(value_len > 0) {
+    --value_len;
+    *out++ = (uint8_t)(value >> (8 * value_len));
+  }
+  len = notification_len - observe_offset - 3;
+  memcpy(out, notification_buffer + observe_offset + 3, len);
+  out += len;
+
+  (obs->obs_counter)++;
+  /* mask out to keep the CoAP observe option length <= 3 bytes */
+  obs->obs_counter &= 0xffffff;
+
+  return out - buffer;
+}
+#endif /* COAP_OBSERVE_RENDER_ONCE */
+/*---------------------------------------------------------------------------*/
 void
 coap_notify_observers(coap_resource_t *resource)
 {
@@ -197,6 +384,11 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   int url_len, obs_url_len;
   char url[COAP_OBSERVER_URL_LEN];
   uint8_t sub_ok = 0;
+  uint8_t replaced;
+#if COAP_OBSERVE_RENDER_ONCE
+  uint8_t rendered = 0;
+  coap_message_type_t type;
+#endif /* COAP_OBSERVE_RENDER_ONCE */
 
   if(resource != NULL) {
     url_len = strlen(resource->url);
@@ -227,7 +419,7 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   sub_ok = (resource == NULL) || (resource->flags & HAS_SUB_RESOURCES);
   for(obs = (coap_observer_t *)list_head(observers_list); obs;
       obs = obs->next) {
-    obs_url_len = strlen(obs->url);
+    obs_url_len = obs->url_len;
 
     /* Do a match based on the parent/sub-resource match so that it is
        possible to do parent-node observe */
@@ -241,9 +433,45 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
        && strncmp(url, obs->url, url_len) == 0) {
       coap_transaction_t *transaction = NULL;
 
+#if COAP_OBSERVE_RENDER_ONCE
+      /* Render before taking a transaction, so that a notification
+         that cannot be serialized neither takes a transaction nor
+         replaces the pending one of an observer. */
+      if(!rendered) {
+        render_notification(resource, request, notification);
+        rendered = 1;
+      }
+      if(notification_len < COAP_HEADER_LEN) {
+        break;
+      }
+
+      if((transaction = new_notification_transaction(obs, &replaced))) {
+        LOG_DBG("           Observer ");
+        LOG_DBG_COAP_EP(&obs->endpoint);
+        LOG_DBG_("\n");
+
+        /* update last MID for RST matching */
+        obs->last_mid = transaction->mid;
+
+        if(obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0
+           || replaced) {
+          LOG_DBG("           Force Confirmable for\n");
+          type = COAP_TYPE_CON;
+        } else {
+          type = COAP_TYPE_NON;
+        }
+        transaction->message_len =
+          write_notification(transaction->message, obs, type,
+                             transaction->mid);
+
+        if(!replaced) {
+          coap_send_transaction(transaction);
+        }
+      }
+#else /* COAP_OBSERVE_RENDER_ONCE */
       /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
 
-      if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint))) {
+      if((transaction = new_notification_transaction(obs, &replaced))) {
         if(obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0) {
           LOG_DBG("           Force Confirmable for\n");
           notification->type = COAP_TYPE_CON;
@@ -261,21 +489,8 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
 
 	int32_t new_offset = 0;
 
-        /* Either old style get_handler or the full handler */
-        if(coap_call_handlers(request, notification, transaction->message +
-                              COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
-                              &new_offset) > 0) {
-          LOG_DBG("Notification on new handlers\n");
-        } else {
-          if(resource != NULL) {
-            resource->get_handler(request, notification,
-                                  transaction->message + COAP_MAX_HEADER_SIZE,
-                                  COAP_MAX_CHUNK_SIZE, &new_offset);
-          } else {
-            /* What to do here? */
-            notification->code = BAD_REQUEST_4_00;
-          }
-        }
+        call_notification_handler(resource, request, notification,
+                                  transaction->message, &new_offset);
 
         if(notification->code < BAD_REQUEST_4_00) {
           coap_set_header_observe(notification, (obs->obs_counter)++);
@@ -298,8 +513,16 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
         transaction->message_len =
           coap_serialize_message(notification, transaction->message);
 
-        coap_send_transaction(transaction);
+        if(replaced) {
+          /* The replaced notification was confirmable. */
+          transaction->message[0] =
+            (transaction->message[0] & ~COAP_HEADER_TYPE_MASK) |
+            (COAP_TYPE_CON << COAP_HEADER_TYPE_POSITION);
+        } else {
+          coap_send_transaction(transaction);
+        }
       }
+#endif /* COAP_OBSERVE_RENDER_ONCE */
     }
   }
 }
@@ -357,10 +580,11 @@ uint8_t
 coap_has_observers(char *path)
 {
   coap_observer_t *obs = NULL;
+  size_t path_len = strlen(path);
 
   for(obs = (coap_observer_t *)list_head(observers_list); obs;
       obs = obs->next) {
-    if((strncmp(obs->url, path, strlen(path))) == 0) {
+    if(obs->url_len >= path_len && memcmp(obs->url, path, path_len) == 0) {
       return 1;
     }
   }
@@ -47,16 +47,46 @@
 #include "lib/memb.h"
 #include "lib/list.h"
 #include <stdlib.h>
+#include <string.h>
 
 /* Log configuration */
 #include "coap-log.h"
 #define LOG_MODULE "coap"
 #define LOG_LEVEL  LOG_LEVEL_COAP
 
+#if COAP_CONGESTION_CONTROL
+/* The initial and maximum overall retransmission timeouts, in ms. */
+#define RTO_INITIAL 2000
+#define RTO_MAX     32000
+
+/* Round-trip time estimates of an endpoint, in ms. The strong estimate
+   uses the messages acknowledged without retransmission, the weak one
+   the messages that were retransmitted once or twice. */
+typedef struct coap_peer {
+  coap_endpoint_t endpoint;
+  uint64_t last_update;
+  uint64_t last_use;
+  uint32_t rto;
+  uint32_t strong_srtt;
+  uint32_t strong_rttvar;
+  uint32_t weak_srtt;
+  uint32_t weak_rttvar;
+  uint8_t used;
+  uint8_t active;
+  uint8_t queued;
+} coap_peer_t;
+
+static coap_peer_t peers[COAP_MAX_PEERS];
+#endif /* COAP_CONGESTION_CONTROL */
+
 /*---------------------------------------------------------------------------*/
 MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 LIST(transactions_list);
 
+#if COAP_TRANSACTION_HASH_SIZE
+static coap_transaction_t *transaction_hash[COAP_TRANSACTION_HASH_SIZE];
+#endif /* COAP_TRANSACTION_HASH_SIZE */
+
 /*---------------------------------------------------------------------------*/
 static void
 coap_retransmit_transaction(coap_timer_t *nt)
@@ -71,6 +101,202 @@ coap_retransmit_transaction(coap_timer_t *nt)
   coap_send_transaction(t);
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_TRANSACTION_HASH_SIZE
+static void
+hash_add(coap_transaction_t *t)
+{
+  coap_transaction_t **tp;
+
+  /* Append, so that the oldest transaction with a MID is found first. */
+  t->hash_next = NULL;
+  for(tp = &transaction_hash[t->mid % COAP_TRANSACTION_HASH_SIZE];
+      *tp != NULL; tp = &(*tp)->hash_next);
+  *tp = t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(coap_transaction_t *t)
+{
+  coap_transaction_t **tp;
+
+  for(tp = &transaction_hash[t->mid % COAP_TRANSACTION_HASH_SIZE];
+      *tp != NULL; tp = &(*tp)->hash_next) {
+    if(*tp == t) {
+      *tp = t->hash_next;
+      return;
+    }
+  }
+}
+#endif /* COAP_TRANSACTION_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
+#if COAP_CONGESTION_CONTROL
+/* Find the round-trip state of an endpoint, or take the least recently
+   used one that has no pending message. */
+static coap_peer_t *
+get_peer(const coap_endpoint_t *endpoint)
+{
+  coap_peer_t *peer;
+  coap_peer_t *victim;
+  uint64_t now;
+  uint32_t idle;
+
+  now = coap_timer_uptime();
+  victim = NULL;
+  for(peer = peers; peer < &peers[COAP_MAX_PEERS]; peer++) {
+    if(peer->used && coap_endpoint_cmp(&peer->endpoint, endpoint)) {
+      break;
+    }
+    if(!peer->used) {
+      if(victim == NULL || victim->used) {
+        victim = peer;
+      }
+    } else if(peer->active == 0 && peer->queued == 0 &&
+              (victim == NULL ||
+               (victim->used && peer->last_use < victim->last_use))) {
+      victim = peer;
+    }
+  }
+
+  if(peer == &peers[COAP_MAX_PEERS]) {
+    if(victim == NULL) {
+      return NULL;
+    }
+    peer = victim;
+    memset(peer, 0, sizeof(*peer));
+    coap_endpoint_copy(&peer->endpoint, endpoint);
+    peer->used = 1;
+    peer->rto = RTO_INITIAL;
+    peer->last_update = now;
+  }
+
+  /* Age the estimate if it was not updated for a while. */
+  idle = now - peer->last_update;
+  if(peer->rto < 1000 && idle > 16 * peer->rto) {
+    peer->rto *= 2;
+    peer->last_update = now;
+  } else if(peer->rto > 3000 && idle > 4 * peer->rto) {
+    peer->rto = (RTO_INITIAL + peer->rto) / 2;
+    peer->last_update = now;
+  }
+
+  peer->last_use = now;
+  return peer;
+}
+/*---------------------------------------------------------------------------*/
+/* Update a round-trip time estimator with a measurement, as in RFC 6298,
+   and return its retransmission timeout. */
+static uint32_t
+estimate_rto(uint32_t *srtt, uint32_t *rttvar, uint32_t rtt, int k)
+{
+  if(*srtt == 0) {
+    *srtt = rtt;
+    *rttvar = rtt / 2;
+  } else {
+    *rttvar = (3 * *rttvar +
+               (*srtt > rtt ? *srtt - rtt : rtt - *srtt)) / 4;
+    *srtt = (7 * *srtt + rtt) / 8;
+  }
+  return *srtt + k * *rttvar;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_rto(coap_peer_t *peer, uint32_t rtt, uint8_t retrans_counter)
+{
+  uint32_t rto;
+
+  /* A zero estimate means no measurement yet. */
+  if(rtt == 0) {
+    rtt = 1;
+  }
+  if(retrans_counter == 0) {
+    rto = estimate_rto(&peer->strong_srtt, &peer->strong_rttvar, rtt, 4);
+    peer->rto = (peer->rto + rto) / 2;
+  } else if(retrans_counter <= 2) {
+    rto = estimate_rto(&peer->weak_srtt, &peer->weak_rttvar, rtt, 1);
+    peer->rto = (3 * peer->rto + rto) / 4;
+  } else {
+    return;
+  }
+  if(peer->rto > RTO_MAX) {
+    peer->rto = RTO_MAX;
+  }
+  peer->last_update = coap_timer_uptime();
+  LOG_DBG("RTT %lu ms, RTO %lu ms\n", (unsigned long)rtt,
+          (unsigned long)peer->rto);
+}
+/*---------------------------------------------------------------------------*/
+/* Send the oldest queued confirmable message to the endpoint. */
+static void
+send_queued(coap_peer_t *peer)
+{
+  coap_transaction_t *t;
+
+  for(t = (coap_transaction_t *)list_head(transactions_list); t; t = t->next) {
+    if(t->peer == peer && t->queued) {
+      LOG_DBG("Dequeuing transaction %u\n", t->mid);
+      t->queued = 0;
+      peer->queued--;
+      peer->active++;
+      coap_send_transaction(t);
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Take an NSTART slot of the endpoint for a new confirmable message, or
+   queue the message. Returns 0 if the message is queued. */
+static int
+start_transaction(coap_transaction_t *t)
+{
+  t->peer = get_peer(&t->endpoint);
+  if(t->peer == NULL) {
+    /* No room for the state of the endpoint: send with the defaults. */
+    return 1;
+  }
+  if(t->peer->active >= COAP_NSTART) {
+    LOG_DBG("Queuing transaction %u\n", t->mid);
+    t->queued = 1;
+    t->peer->queued++;
+    return 0;
+  }
+  t->peer->active++;
+  return 1;
+}
+#endif /* COAP_CONGESTION_CONTROL */
+/*---------------------------------------------------------------------------*/
+/* The retransmission timeout of the first transmission of a confirmable
+   message. */
+static uint32_t
+initial_interval(coap_transaction_t *t)
+{
+#if COAP_CONGESTION_CONTROL
+  uint32_t interval;
+
+  if(t->peer != NULL) {
+    /* Between RTO and 1.5 RTO, with a backoff factor that depends on
+       it. */
+    interval = t->peer->rto + rand() % (t->peer->rto / 2 + 1);
+    t->backoff = interval < 1000 ? 6 : interval > 3000 ? 3 : 4;
+    t->start_time = coap_timer_uptime();
+    return interval;
+  }
+#endif /* COAP_CONGESTION_CONTROL */
+  return COAP_RESPONSE_TIMEOUT_TICKS + (rand() %
+                                        COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+}
+/*---------------------------------------------------------------------------*/
+/* The retransmission timeout of a retransmission. */
+static uint32_t
+backoff_interval(coap_transaction_t *t)
+{
+#if COAP_CONGESTION_CONTROL
+  if(t->peer != NULL) {
+    return t->retrans_interval * t->backoff / 2;
+  }
+#endif /* COAP_CONGESTION_CONTROL */
+  return t->retrans_interval << 1;  /* double */
+}
+/*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
@@ -83,11 +309,18 @@ coap_new_transaction(uint16_t mid, const coap_endpoint_t *endpoint)
   if(t) {
     t->mid = mid;
     t->retrans_counter = 0;
+#if COAP_CONGESTION_CONTROL
+    t->queued = 0;
+    t->peer = NULL;
+#endif /* COAP_CONGESTION_CONTROL */
 
     /* save client address */
     coap_endpoint_copy(&t->endpoint, endpoint);
 
     list_add(transactions_list, t); /* list itself makes sure same element is not added twice */
+#if COAP_TRANSACTION_HASH_SIZE
+    hash_add(t);
+#endif /* COAP_TRANSACTION_HASH_SIZE */
   }
 
   return t;
@@ -96,6 +329,18 @@ coap_new_transaction(uint16_t mid, const coap_endpoint_t *endpoint)
 void
 coap_send_transaction(coap_transaction_t *t)
 {
+#if COAP_CONGESTION_CONTROL
+  if(t->queued) {
+    return;
+  }
+  if(COAP_TYPE_CON ==
+     ((COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION)
+     && t->retrans_counter == 0 && t->peer == NULL
+     && !start_transaction(t)) {
+    return;
+  }
+#endif /* COAP_CONGESTION_CONTROL */
+
   LOG_DBG("Sending transaction %u\n", t->mid);
 
   coap_sendto(&t->endpoint, t->message, t->message_len);
@@ -109,13 +354,11 @@ coap_send_transaction(coap_transaction_t *t)
       if(t->retrans_counter == 0) {
         coap_timer_set_callback(&t->retrans_timer, coap_retransmit_transaction);
         coap_timer_set_user_data(&t->retrans_timer, t);
-        t->retrans_interval =
-          COAP_RESPONSE_TIMEOUT_TICKS + (rand() %
-                                         COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+        t->retrans_interval = initial_interval(t);
         LOG_DBG("Initial interval %lu msec\n",
                 (unsigned long)t->retrans_interval);
       } else {
-        t->retrans_interval <<= 1;  /* double */
+        t->retrans_interval = backoff_interval(t);
         LOG_DBG("Doubled (%u) interval %lu s\n", t->retrans_counter,
                 (unsigned long)(t->retrans_interval / 1000));
       }
@@ -150,16 +393,49 @@ coap_clear_transaction(coap_transaction_t *t)
 
     coap_timer_stop(&t->retrans_timer);
     list_remove(transactions_list, t);
+#if COAP_TRANSACTION_HASH_SIZE
+    hash_remove(t);
+#endif /* COAP_TRANSACTION_HASH_SIZE */
+
+#if COAP_CONGESTION_CONTROL
+    if(t->peer != NULL) {
+      if(t->queued) {
+        t->peer->queued--;
+      } else {
+        /* Free the NSTART slot for the next queued message. */
+        t->peer->active--;
+        send_queued(t->peer);
+      }
+    }
+#endif /* COAP_CONGESTION_CONTROL */
+
     memb_free(&transactions_memb, t);
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+coap_complete_transaction(coap_transaction_t *t)
+{
+#if COAP_CONGESTION_CONTROL
+  if(t->peer != NULL && !t->queued) {
+    update_rto(t->peer, coap_timer_uptime() - t->start_time,
+               t->retrans_counter);
+  }
+#endif /* COAP_CONGESTION_CONTROL */
+  coap_clear_transaction(t);
+}
+/*---------------------------------------------------------------------------*/
 coap_transaction_t *
 coap_get_transaction_by_mid(uint16_t mid)
 {
   coap_transaction_t *t = NULL;
 
+#if COAP_TRANSACTION_HASH_SIZE
+  for(t = transaction_hash[mid % COAP_TRANSACTION_HASH_SIZE]; t;
+      t = t->hash_next) {
+#else /* COAP_TRANSACTION_HASH_SIZE */
   for(t = (coap_transaction_t *)list_head(transactions_list); t; t = t->next) {
+#endif /* COAP_TRANSACTION_HASH_SIZE */
     if(t->mid == mid) {
       LOG_DBG("Found transaction for MID %u: %p\n", t->mid, t);
       return t;
@@ -168,4 +444,33 @@ coap_get_transaction_by_mid(uint16_t mid)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_CONGESTION_CONTROL
+coap_transaction_t *
+coap_replace_transaction(uint16_t mid, const coap_endpoint_t *endpoint,
+                         const uint8_t *token, size_t token_len,
+                         uint16_t new_mid)
+{
+  coap_transaction_t *t;
+
+  t = coap_get_transaction_by_mid(mid);
+  if(t == NULL || !coap_endpoint_cmp(&t->endpoint, endpoint)
+     || (COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION
+     != COAP_TYPE_CON
+     || (t->message[0] & COAP_HEADER_TOKEN_LEN_MASK) != token_len
+     || memcmp(t->message + COAP_HEADER_LEN, token, token_len) != 0) {
+    return NULL;
+  }
+
+  LOG_DBG("Replacing transaction %u with %u\n", t->mid, new_mid);
+#if COAP_TRANSACTION_HASH_SIZE
+  hash_remove(t);
+  t->mid = new_mid;
+  hash_add(t);
+#else /* COAP_TRANSACTION_HASH_SIZE */
+  t->mid = new_mid;
+#endif /* COAP_TRANSACTION_HASH_SIZE */
+  return t;
+}
+#endif /* COAP_CONGESTION_CONTROL */
+/*---------------------------------------------------------------------------*/
 /** @} */
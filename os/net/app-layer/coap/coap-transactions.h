@@ -55,14 +55,25 @@
 #define COAP_RESPONSE_TIMEOUT_TICKS         (1000 * COAP_RESPONSE_TIMEOUT)
 #define COAP_RESPONSE_TIMEOUT_BACKOFF_MASK  (uint32_t)(((1000 * COAP_RESPONSE_TIMEOUT * ((float)COAP_RESPONSE_RANDOM_FACTOR - 1.0)) + 0.5) + 1)
 
+struct coap_peer;
+
 /* container for transactions with message buffer and retransmission info */
 typedef struct coap_transaction {
   struct coap_transaction *next;        /* for LIST */
+#if COAP_TRANSACTION_HASH_SIZE
+  struct coap_transaction *hash_next;   /* next transaction in the same bucket */
+#endif /* COAP_TRANSACTION_HASH_SIZE */
 
   uint16_t mid;
   coap_timer_t retrans_timer;
   uint32_t retrans_interval;
   uint8_t retrans_counter;
+#if COAP_CONGESTION_CONTROL
+  uint8_t queued;                       /* waiting for an NSTART slot */
+  uint8_t backoff;                      /* backoff factor, in halves */
+  uint64_t start_time;                  /* time of the first transmission */
+  struct coap_peer *peer;               /* round-trip state of the endpoint */
+#endif /* COAP_CONGESTION_CONTROL */
 
   coap_endpoint_t endpoint;
 
@@ -79,5 +90,34 @@ void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
 
+/**
+ * \brief      Clear a transaction whose ACK, RST or response was received.
+ *
+ *             With COAP_CONGESTION_CONTROL, this also updates the
+ *             round-trip time estimate of the endpoint.
+ * \param t    The transaction.
+ */
+void coap_complete_transaction(coap_transaction_t *t);
+
+#if COAP_CONGESTION_CONTROL
+/**
+ * \brief      Take over a pending confirmable notification.
+ *
+ *             Finds the transaction of the confirmable message with MID
+ *             mid and the given token to endpoint, which has not been
+ *             acknowledged yet, and gives it the MID new_mid so that
+ *             its message can be replaced with a newer notification.
+ *             The new message is sent at the next retransmission, or
+ *             when the transaction leaves the NSTART queue, and must
+ *             not be passed to coap_send_transaction().
+ * \return     The transaction, or NULL if there is none.
+ */
+coap_transaction_t *coap_replace_transaction(uint16_t mid,
+                                             const coap_endpoint_t *endpoint,
+                                             const uint8_t *token,
+                                             size_t token_len,
+                                             uint16_t new_mid);
+#endif /* COAP_CONGESTION_CONTROL */
+
 #endif /* COAP_TRANSACTIONS_H_ */
 /** @} */
@@ -126,6 +126,12 @@ typedef enum {
 /*---------------------------------------------------------------------------*/
 #define INCREMENT_MID(conn)   (conn)->mid_counter += 2
 #define MQTT_STRING_LENGTH(s) (((s)->length) == 0 ? 0 : (MQTT_STRING_LEN_SIZE + (s)->length))
+
+/* Bytes of the incoming packet that have not been read yet */
+#define IN_PACKET_LEFT(conn) (MQTT_FHDR_SIZE +                                 \
+                              (conn)->in_packet.remaining_length_bytes +       \
+                              (conn)->in_packet.remaining_length -             \
+                              (conn)->in_packet.byte_counter)
 /*---------------------------------------------------------------------------*/
 /* Protothread send macros */
 #define PT_MQTT_WRITE_BYTES(conn, data, len)                                   \
@@ -213,6 +219,9 @@ reset_defaults(struct mqtt_connection *conn)
 
   reset_packet(&conn->in_packet);
   conn->out_buffer_sent = 0;
+#if MQTT_MAX_INFLIGHT > 1
+  memset(conn->inflight, 0, sizeof(conn->inflight));
+#endif /* MQTT_MAX_INFLIGHT > 1 */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -259,6 +268,18 @@ disconnect_tcp(struct mqtt_connection *conn)
   memset(&conn->socket, 0, sizeof(conn->socket));
 }
 /*---------------------------------------------------------------------------*/
+#if MQTT_STREAMING
+/*
+ * The out buffer is the output buffer of the TCP socket. Packets are written
+ * in place behind the data still awaiting a TCP ACK, and queued for
+ * transmission with a zero-length send once complete.
+ */
+static void
+send_out_buffer(struct mqtt_connection *conn)
+{
+  tcp_socket_send(&conn->socket, conn->out_buffer, 0);
+}
+#else /* MQTT_STREAMING */
 static void
 send_out_buffer(struct mqtt_connection *conn)
 {
@@ -274,6 +295,7 @@ send_out_buffer(struct mqtt_connection *conn)
   tcp_socket_send(&conn->socket, conn->out_buffer,
                   conn->out_buffer_ptr - conn->out_buffer);
 }
+#endif /* MQTT_STREAMING */
 /*---------------------------------------------------------------------------*/
 static void
 string_to_mqtt_string(struct mqtt_string *mqtt_string, char *string)
@@ -290,6 +312,45 @@ string_to_mqtt_string(struct mqtt_string *mqtt_string, char *string)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if MQTT_STREAMING
+static int
+write_byte(struct mqtt_connection *conn, uint8_t data)
+{
+  if(tcp_socket_max_sendlen(&conn->socket) == 0) {
+    conn->out_buffer_sent = 0;
+    send_out_buffer(conn);
+    return 1;
+  }
+
+  conn->out_buffer[conn->socket.output_data_len++] = data;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+write_bytes(struct mqtt_connection *conn, uint8_t *data, uint16_t len)
+{
+  uint16_t write_bytes;
+  write_bytes = MIN(tcp_socket_max_sendlen(&conn->socket),
+                    len - conn->out_write_pos);
+
+  memcpy(&conn->out_buffer[conn->socket.output_data_len],
+         &data[conn->out_write_pos], write_bytes);
+  conn->out_write_pos += write_bytes;
+  conn->socket.output_data_len += write_bytes;
+
+  DBG("MQTT - (write_bytes) len: %u write_pos: %lu\n", len,
+      conn->out_write_pos);
+
+  if(len - conn->out_write_pos == 0) {
+    conn->out_write_pos = 0;
+    return 0;
+  } else {
+    conn->out_buffer_sent = 0;
+    send_out_buffer(conn);
+    return len - conn->out_write_pos;
+  }
+}
+#else /* MQTT_STREAMING */
 static int
 write_byte(struct mqtt_connection *conn, uint8_t data)
 {
@@ -330,6 +391,7 @@ write_bytes(struct mqtt_connection *conn, uint8_t *data, uint16_t len)
     return len - conn->out_write_pos;
   }
 }
+#endif /* MQTT_STREAMING */
 /*---------------------------------------------------------------------------*/
 static void
 encode_remaining_length(uint8_t *remaining_length,
@@ -378,6 +440,41 @@ reset_packet(struct mqtt_in_packet *packet)
   memset(packet, 0, sizeof(struct mqtt_in_packet));
   packet->remaining_multiplier = 1;
 }
+#if MQTT_MAX_INFLIGHT > 1
+/*---------------------------------------------------------------------------*/
+/*
+ * Releases the slots of messages that have not been acknowledged in time.
+ * Like the stop-and-wait path on a PUBACK timeout, they are given up on.
+ */
+static void
+inflight_expire(struct mqtt_connection *conn)
+{
+  struct mqtt_inflight *entry;
+
+  for(entry = conn->inflight; entry < &conn->inflight[MQTT_MAX_INFLIGHT];
+      entry++) {
+    if(entry->mid != 0 &&
+       clock_time() - entry->sent >= RESPONSE_WAIT_TIMEOUT) {
+      DBG("MQTT - Timeout waiting for PUBACK of MID %u\n", entry->mid);
+      entry->mid = 0;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct mqtt_inflight *
+inflight_lookup(struct mqtt_connection *conn, uint16_t mid)
+{
+  struct mqtt_inflight *entry;
+
+  for(entry = conn->inflight; entry < &conn->inflight[MQTT_MAX_INFLIGHT];
+      entry++) {
+    if(entry->mid == mid) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+#endif /* MQTT_MAX_INFLIGHT > 1 */
 /*---------------------------------------------------------------------------*/
 static
 PT_THREAD(connect_pt(struct pt *pt, struct mqtt_connection *conn))
@@ -416,16 +513,16 @@ PT_THREAD(connect_pt(struct pt *pt, struct mqtt_connection *conn))
   PT_MQTT_WRITE_BYTE(conn, conn->connect_vhdr_flags);
   PT_MQTT_WRITE_BYTE(conn, (conn->keep_alive >> 8));
   PT_MQTT_WRITE_BYTE(conn, (conn->keep_alive & 0x00FF));
-  PT_MQTT_WRITE_BYTE(conn, conn->client_id.length << 8);
+  PT_MQTT_WRITE_BYTE(conn, conn->client_id.length >> 8);
   PT_MQTT_WRITE_BYTE(conn, conn->client_id.length & 0x00FF);
   PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->client_id.string,
                       conn->client_id.length);
   if(conn->connect_vhdr_flags & MQTT_VHDR_WILL_FLAG) {
-    PT_MQTT_WRITE_BYTE(conn, conn->will.topic.length << 8);
+    PT_MQTT_WRITE_BYTE(conn, conn->will.topic.length >> 8);
     PT_MQTT_WRITE_BYTE(conn, conn->will.topic.length & 0x00FF);
     PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->will.topic.string,
                         conn->will.topic.length);
-    PT_MQTT_WRITE_BYTE(conn, conn->will.message.length << 8);
+    PT_MQTT_WRITE_BYTE(conn, conn->will.message.length >> 8);
     PT_MQTT_WRITE_BYTE(conn, conn->will.message.length & 0x00FF);
     PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->will.message.string,
                         conn->will.message.length);
@@ -436,14 +533,14 @@ PT_THREAD(connect_pt(struct pt *pt, struct mqtt_connection *conn))
         conn->will.message.length);
   }
   if(conn->connect_vhdr_flags & MQTT_VHDR_USERNAME_FLAG) {
-    PT_MQTT_WRITE_BYTE(conn, conn->credentials.username.length << 8);
+    PT_MQTT_WRITE_BYTE(conn, conn->credentials.username.length >> 8);
     PT_MQTT_WRITE_BYTE(conn, conn->credentials.username.length & 0x00FF);
     PT_MQTT_WRITE_BYTES(conn,
                         (uint8_t *)conn->credentials.username.string,
                         conn->credentials.username.length);
   }
   if(conn->connect_vhdr_flags & MQTT_VHDR_PASSWORD_FLAG) {
-    PT_MQTT_WRITE_BYTE(conn, conn->credentials.password.length << 8);
+    PT_MQTT_WRITE_BYTE(conn, conn->credentials.password.length >> 8);
     PT_MQTT_WRITE_BYTE(conn, conn->credentials.password.length & 0x00FF);
     PT_MQTT_WRITE_BYTES(conn,
                         (uint8_t *)conn->credentials.password.string,
@@ -497,7 +594,12 @@ PT_THREAD(disconnect_pt(struct pt *pt, struct mqtt_connection *conn))
    * tear down the session.
    */
   timer_set(&conn->t, (CLOCK_SECOND * 2));
+#if MQTT_STREAMING
+  PT_WAIT_UNTIL(pt, tcp_socket_queuelen(&conn->socket) == 0 ||
+                timer_expired(&conn->t));
+#else /* MQTT_STREAMING */
   PT_WAIT_UNTIL(pt, conn->out_buffer_sent || timer_expired(&conn->t));
+#endif /* MQTT_STREAMING */
 
   PT_END(pt);
 }
@@ -534,7 +636,7 @@ PT_THREAD(subscribe_pt(struct pt *pt, struct mqtt_connection *conn))
                       conn->out_packet.remaining_length_enc,
                       conn->out_packet.remaining_length_enc_bytes);
   /* Write Variable Header */
-  PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid << 8));
+  PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid >> 8));
   PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid & 0x00FF));
   /* Write Payload */
   PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.topic_length >> 8));
@@ -596,7 +698,7 @@ PT_THREAD(unsubscribe_pt(struct pt *pt, struct mqtt_connection *conn))
   PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->out_packet.remaining_length_enc,
                       conn->out_packet.remaining_length_enc_bytes);
   /* Write Variable Header */
-  PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid << 8));
+  PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid >> 8));
   PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid & 0x00FF));
   /* Write Payload */
   PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.topic_length >> 8));
@@ -669,7 +771,7 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
   PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->out_packet.topic,
                       conn->out_packet.topic_length);
   if(conn->out_packet.qos > MQTT_QOS_LEVEL_0) {
-    PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid << 8));
+    PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid >> 8));
     PT_MQTT_WRITE_BYTE(conn, (conn->out_packet.mid & 0x00FF));
   }
   /* Write Payload */
@@ -688,6 +790,14 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
    */
   if(conn->out_packet.qos == 0) {
     process_post(conn->app_process, mqtt_update_event, NULL);
+#if MQTT_MAX_INFLIGHT > 1
+  } else if(conn->out_packet.qos == 1) {
+    /*
+     * The message took an in-flight slot in mqtt_publish() and its PUBACK is
+     * matched in handle_puback(): the next message can be sent right away.
+     */
+    process_post(conn->app_process, mqtt_update_event, NULL);
+#else /* MQTT_MAX_INFLIGHT > 1 */
   } else if(conn->out_packet.qos == 1) {
     /* Wait for PUBACK */
     reset_packet(&conn->in_packet);
@@ -700,12 +810,15 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
       DBG("MQTT - Warning, got PUBACK with none matching MID. Currently there "
           "is no support for several concurrent PUBLISH messages.\n");
     }
+#endif /* MQTT_MAX_INFLIGHT > 1 */
   } else if(conn->out_packet.qos == 2) {
     DBG("MQTT - QoS not implemented yet.\n");
     /* Should wait for PUBREC, send PUBREL and then wait for PUBCOMP */
   }
 
+#if MQTT_MAX_INFLIGHT == 1
   reset_packet(&conn->in_packet);
+#endif /* MQTT_MAX_INFLIGHT == 1 */
 
   /* This is clear after the entire transaction is complete */
   conn->out_queue_full = 0;
@@ -824,12 +937,31 @@ handle_unsuback(struct mqtt_connection *conn)
 static void
 handle_puback(struct mqtt_connection *conn)
 {
+#if MQTT_MAX_INFLIGHT > 1
+  struct mqtt_inflight *entry;
+#endif /* MQTT_MAX_INFLIGHT > 1 */
+
   DBG("MQTT - Got PUBACK\n");
 
-  conn->out_packet.qos_state = MQTT_QOS_STATE_GOT_ACK;
   conn->in_packet.mid = (conn->in_packet.payload[0] << 8) |
     (conn->in_packet.payload[1]);
 
+#if MQTT_MAX_INFLIGHT > 1
+  /*
+   * The out packet may be a SUBSCRIBE or UNSUBSCRIBE awaiting its own ACK by
+   * now, so only the in-flight slot is released.
+   */
+  entry = inflight_lookup(conn, conn->in_packet.mid);
+  if(entry != NULL) {
+    entry->mid = 0;
+  } else {
+    DBG("MQTT - Warning, got PUBACK for MID %u that is not in flight\n",
+        conn->in_packet.mid);
+  }
+#else /* MQTT_MAX_INFLIGHT > 1 */
+  conn->out_packet.qos_state = MQTT_QOS_STATE_GOT_ACK;
+#endif /* MQTT_MAX_INFLIGHT > 1 */
+
   call_event(conn, MQTT_EVENT_PUBACK, &conn->in_packet.mid);
 }
 /*---------------------------------------------------------------------------*/
@@ -906,6 +1038,7 @@ parse_publish_vhdr(struct mqtt_connection *conn,
       conn->in_publish_msg.payload_length =
         conn->in_packet.remaining_length - conn->in_packet.topic_len - 2;
       conn->in_publish_msg.payload_left = conn->in_publish_msg.payload_length;
+      conn->in_publish_msg.payload_chunk_length = 0;
     }
 
     /* Set this once per incomming publish message */
@@ -913,6 +1046,54 @@ parse_publish_vhdr(struct mqtt_connection *conn,
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+handle_packet(struct mqtt_connection *conn)
+{
+  /* Handle packet here. */
+  switch(conn->in_packet.fhdr & 0xF0) {
+  case MQTT_FHDR_MSG_TYPE_CONNACK:
+    handle_connack(conn);
+    break;
+  case MQTT_FHDR_MSG_TYPE_PUBLISH:
+    /* This is the only or the last chunk of publish payload */
+#if !MQTT_STREAMING
+    conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
+    conn->in_publish_msg.payload_chunk_length = conn->in_packet.payload_pos;
+#endif /* !MQTT_STREAMING */
+    conn->in_publish_msg.payload_left = 0;
+    handle_publish(conn);
+    break;
+  case MQTT_FHDR_MSG_TYPE_PUBACK:
+    handle_puback(conn);
+    break;
+  case MQTT_FHDR_MSG_TYPE_SUBACK:
+    handle_suback(conn);
+    break;
+  case MQTT_FHDR_MSG_TYPE_UNSUBACK:
+    handle_unsuback(conn);
+    break;
+  case MQTT_FHDR_MSG_TYPE_PINGRESP:
+    handle_pingresp(conn);
+    break;
+
+  /* QoS 2 not implemented yet */
+  case MQTT_FHDR_MSG_TYPE_PUBREC:
+  case MQTT_FHDR_MSG_TYPE_PUBREL:
+  case MQTT_FHDR_MSG_TYPE_PUBCOMP:
+    call_event(conn, MQTT_EVENT_NOT_IMPLEMENTED_ERROR, NULL);
+    PRINTF("MQTT - Got unhandled MQTT Message Type '%i'",
+           (conn->in_packet.fhdr & 0xF0));
+    break;
+
+  default:
+    /* All server-only message */
+    PRINTF("MQTT - Got MQTT Message Type '%i'", (conn->in_packet.fhdr & 0xF0));
+    break;
+  }
+
+  conn->in_packet.packet_received = 1;
+}
+/*---------------------------------------------------------------------------*/
 static int
 tcp_input(struct tcp_socket *s,
           void *ptr,
@@ -928,170 +1109,153 @@ tcp_input(struct tcp_socket *s,
     return 0;
   }
 
-  if(conn->in_packet.packet_received) {
-    reset_packet(&conn->in_packet);
-  }
-
   DBG("tcp_input with %i bytes of data:\n", input_data_len);
 
-  /* Read the fixed header field, if we do not have it */
-  if(!conn->in_packet.fhdr) {
-    conn->in_packet.fhdr = input_data_ptr[pos++];
-    conn->in_packet.byte_counter++;
+  /* A segment may carry several packets, e.g. PUBACKs for a window */
+  while(pos < input_data_len) {
+    if(conn->in_packet.packet_received) {
+      reset_packet(&conn->in_packet);
+    }
 
-    DBG("MQTT - Read VHDR '%02X'\n", conn->in_packet.fhdr);
+    /* Read the fixed header field, if we do not have it */
+    if(!conn->in_packet.fhdr) {
+      conn->in_packet.fhdr = input_data_ptr[pos++];
+      conn->in_packet.byte_counter++;
 
-    if(pos >= input_data_len) {
-      return 0;
-    }
-  }
+      DBG("MQTT - Read VHDR '%02X'\n", conn->in_packet.fhdr);
 
-  /* Read the Remaining Length field, if we do not have it */
-  if(!conn->in_packet.has_remaining_length) {
-    do {
       if(pos >= input_data_len) {
         return 0;
       }
+    }
 
-      byte = input_data_ptr[pos++];
-      conn->in_packet.byte_counter++;
-      conn->in_packet.remaining_length_bytes++;
-      DBG("MQTT - Read Remaining Length byte\n");
+    /* Read the Remaining Length field, if we do not have it */
+    if(!conn->in_packet.has_remaining_length) {
+      do {
+        if(pos >= input_data_len) {
+          return 0;
+        }
 
-      if(conn->in_packet.byte_counter > 5) {
-        call_event(conn, MQTT_EVENT_ERROR, NULL);
-        DBG("Received more then 4 byte 'remaining lenght'.");
-        return 0;
-      }
+        byte = input_data_ptr[pos++];
+        conn->in_packet.byte_counter++;
+        conn->in_packet.remaining_length_bytes++;
+        DBG("MQTT - Read Remaining Length byte\n");
 
-      conn->in_packet.remaining_length +=
-        (byte & 127) * conn->in_packet.remaining_multiplier;
-      conn->in_packet.remaining_multiplier *= 128;
-    } while((byte & 128) != 0);
+        if(conn->in_packet.byte_counter > 5) {
+          call_event(conn, MQTT_EVENT_ERROR, NULL);
+          DBG("Received more then 4 byte 'remaining lenght'.");
+          return 0;
+        }
 
-    DBG("MQTT - Finished reading remaining length byte\n");
-    conn->in_packet.has_remaining_length = 1;
-  }
+        conn->in_packet.remaining_length +=
+          (byte & 127) * conn->in_packet.remaining_multiplier;
+        conn->in_packet.remaining_multiplier *= 128;
+      } while((byte & 128) != 0);
 
-  /*
-   * Check for unsupported payload length. Will read all incoming data from the
-   * server in any case and then reset the packet.
-   *
-   * TODO: Decide if we, for example, want to disconnect instead.
-   */
-  if((conn->in_packet.remaining_length > MQTT_INPUT_BUFF_SIZE) &&
-     (conn->in_packet.fhdr & 0xF0) != MQTT_FHDR_MSG_TYPE_PUBLISH) {
-
-    PRINTF("MQTT - Error, unsupported payload size for non-PUBLISH message\n");
+      DBG("MQTT - Finished reading remaining length byte\n");
+      conn->in_packet.has_remaining_length = 1;
+    }
 
-    conn->in_packet.byte_counter += input_data_len;
-    if(conn->in_packet.byte_counter >=
-       (MQTT_FHDR_SIZE + conn->in_packet.remaining_length)) {
-      conn->in_packet.packet_received = 1;
+    /*
+     * Check for unsupported payload length. Will read all incoming data of the
+     * packet from the server in any case and then reset the packet.
+     *
+     * TODO: Decide if we, for example, want to disconnect instead.
+     */
+    if((conn->in_packet.remaining_length > MQTT_INPUT_BUFF_SIZE) &&
+       (conn->in_packet.fhdr & 0xF0) != MQTT_FHDR_MSG_TYPE_PUBLISH) {
+
+      PRINTF("MQTT - Error, unsupported payload size for non-PUBLISH message\n");
+
+      copy_bytes = MIN(input_data_len - pos, IN_PACKET_LEFT(conn));
+      conn->in_packet.byte_counter += copy_bytes;
+      pos += copy_bytes;
+      if(IN_PACKET_LEFT(conn) == 0) {
+        conn->in_packet.packet_received = 1;
+      }
+      continue;
     }
-    return 0;
-  }
 
-  /*
-   * Supported payload, reads out both VHDR and Payload of all packets.
-   *
-   * Note: There will always be at least one byte left to read when we enter
-   *       this loop.
-   */
-  while(conn->in_packet.byte_counter <
-        (MQTT_FHDR_SIZE + conn->in_packet.remaining_length)) {
+    /* Reads out both VHDR and Payload of the packet. */
+    while(IN_PACKET_LEFT(conn) > 0 && pos < input_data_len) {
 
-    if((conn->in_packet.fhdr & 0xF0) == MQTT_FHDR_MSG_TYPE_PUBLISH &&
-       conn->in_packet.topic_received == 0) {
-      parse_publish_vhdr(conn, &pos, input_data_ptr, input_data_len);
-    }
+      if((conn->in_packet.fhdr & 0xF0) == MQTT_FHDR_MSG_TYPE_PUBLISH &&
+         conn->in_packet.topic_received == 0) {
+        parse_publish_vhdr(conn, &pos, input_data_ptr, input_data_len);
+        continue;
+      }
 
-    /* Read in as much as we can into the packet payload */
-    copy_bytes = MIN(input_data_len - pos,
-                     MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos);
-    DBG("- Copied %lu payload bytes\n", copy_bytes);
-    memcpy(&conn->in_packet.payload[conn->in_packet.payload_pos],
-           &input_data_ptr[pos],
-           copy_bytes);
-    conn->in_packet.byte_counter += copy_bytes;
-    conn->in_packet.payload_pos += copy_bytes;
-    pos += copy_bytes;
+      copy_bytes = MIN(input_data_len - pos, IN_PACKET_LEFT(conn));
 
-    uint8_t i;
-    DBG("MQTT - Copied bytes: \n");
-    for(i = 0; i < copy_bytes; i++) {
-      DBG("%02X ", conn->in_packet.payload[i]);
-    }
-    DBG("\n");
+#if MQTT_STREAMING
+      if((conn->in_packet.fhdr & 0xF0) == MQTT_FHDR_MSG_TYPE_PUBLISH) {
+        /* Hand the payload over in place, in the TCP input buffer */
+        conn->in_publish_msg.payload_chunk = (uint8_t *)&input_data_ptr[pos];
+        conn->in_publish_msg.payload_chunk_length = copy_bytes;
+        conn->in_publish_msg.payload_left -= copy_bytes;
+        conn->in_packet.byte_counter += copy_bytes;
+        pos += copy_bytes;
+
+        /* The last chunk is handled with the complete packet below */
+        if(IN_PACKET_LEFT(conn) > 0) {
+          handle_publish(conn);
+        }
+        continue;
+      }
+#endif /* MQTT_STREAMING */
+
+      /* Read in as much as we can into the packet payload */
+      copy_bytes = MIN(copy_bytes,
+                       MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos);
+      DBG("- Copied %lu payload bytes\n", copy_bytes);
+      memcpy(&conn->in_packet.payload[conn->in_packet.payload_pos],
+             &input_data_ptr[pos],
+             copy_bytes);
+      conn->in_packet.byte_counter += copy_bytes;
+      conn->in_packet.payload_pos += copy_bytes;
+      pos += copy_bytes;
+
+#if DEBUG_MQTT == 1
+      uint16_t i;
+      DBG("MQTT - Copied bytes: \n");
+      for(i = 0; i < copy_bytes; i++) {
+        DBG("%02X ", conn->in_packet.payload[i]);
+      }
+      DBG("\n");
+#endif
 
-    /* Full buffer, shall only happen to PUBLISH messages. */
-    if(MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos == 0) {
-      conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
-      conn->in_publish_msg.payload_chunk_length = MQTT_INPUT_BUFF_SIZE;
-      conn->in_publish_msg.payload_left -= MQTT_INPUT_BUFF_SIZE;
+      /*
+       * Full buffer, shall only happen to PUBLISH messages. The last chunk is
+       * handled with the complete packet below.
+       */
+      if(MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos == 0 &&
+         IN_PACKET_LEFT(conn) > 0) {
+        conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
+        conn->in_publish_msg.payload_chunk_length = MQTT_INPUT_BUFF_SIZE;
+        conn->in_publish_msg.payload_left -= MQTT_INPUT_BUFF_SIZE;
 
-      handle_publish(conn);
+        handle_publish(conn);
 
-      conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
-      conn->in_packet.payload_pos = 0;
+        conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
+        conn->in_packet.payload_pos = 0;
+      }
     }
 
-    if(pos >= input_data_len &&
-       (conn->in_packet.byte_counter < (MQTT_FHDR_SIZE + conn->in_packet.remaining_length))) {
+    if(IN_PACKET_LEFT(conn) > 0) {
       return 0;
     }
-  }
-
-  /* Debug information */
-  DBG("\n");
-  /* Take care of input */
-  DBG("MQTT - Finished reading packet!\n");
-  /* What to return? */
-  DBG("MQTT - total data was %i bytes of data. \n",
-      (MQTT_FHDR_SIZE + conn->in_packet.remaining_length));
 
-  /* Handle packet here. */
-  switch(conn->in_packet.fhdr & 0xF0) {
-  case MQTT_FHDR_MSG_TYPE_CONNACK:
-    handle_connack(conn);
-    break;
-  case MQTT_FHDR_MSG_TYPE_PUBLISH:
-    /* This is the only or the last chunk of publish payload */
-    conn->in_publish_msg.payload_chunk = conn->in_packet.payload;
-    conn->in_publish_msg.payload_chunk_length = conn->in_packet.payload_pos;
-    conn->in_publish_msg.payload_left = 0;
-    handle_publish(conn);
-    break;
-  case MQTT_FHDR_MSG_TYPE_PUBACK:
-    handle_puback(conn);
-    break;
-  case MQTT_FHDR_MSG_TYPE_SUBACK:
-    handle_suback(conn);
-    break;
-  case MQTT_FHDR_MSG_TYPE_UNSUBACK:
-    handle_unsuback(conn);
-    break;
-  case MQTT_FHDR_MSG_TYPE_PINGRESP:
-    handle_pingresp(conn);
-    break;
-
-  /* QoS 2 not implemented yet */
-  case MQTT_FHDR_MSG_TYPE_PUBREC:
-  case MQTT_FHDR_MSG_TYPE_PUBREL:
-  case MQTT_FHDR_MSG_TYPE_PUBCOMP:
-    call_event(conn, MQTT_EVENT_NOT_IMPLEMENTED_ERROR, NULL);
-    PRINTF("MQTT - Got unhandled MQTT Message Type '%i'",
-           (conn->in_packet.fhdr & 0xF0));
-    break;
+    /* Debug information */
+    DBG("\n");
+    /* Take care of input */
+    DBG("MQTT - Finished reading packet!\n");
+    /* What to return? */
+    DBG("MQTT - total data was %i bytes of data. \n",
+        (MQTT_FHDR_SIZE + conn->in_packet.remaining_length));
 
-  default:
-    /* All server-only message */
-    PRINTF("MQTT - Got MQTT Message Type '%i'", (conn->in_packet.fhdr & 0xF0));
-    break;
+    handle_packet(conn);
   }
 
-  conn->in_packet.packet_received = 1;
-
   return 0;
 }
 /*---------------------------------------------------------------------------*/
@@ -1134,10 +1298,15 @@ tcp_event(struct tcp_socket *s, void *ptr, tcp_socket_event_t event)
   case TCP_SOCKET_DATA_SENT: {
     DBG("MQTT - Got TCP_DATA_SENT\n");
 
+#if MQTT_STREAMING
+    /* There is room for writes again */
+    conn->out_buffer_sent = 1;
+#else /* MQTT_STREAMING */
     if(conn->socket.output_data_len == 0) {
       conn->out_buffer_sent = 1;
       conn->out_buffer_ptr = conn->out_buffer;
     }
+#endif /* MQTT_STREAMING */
 
     ctimer_restart(&conn->keep_alive_timer);
     break;
@@ -1253,6 +1422,12 @@ PROCESS_THREAD(mqtt_process, ev, data)
               publish_pt(&conn->out_proto_thread, conn) < PT_EXITED) {
           PT_MQTT_WAIT_SEND();
         }
+      } else if(conn->state == MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
+        /*
+         * The previous packet has not been sent yet. Retry, rather than
+         * leave the accepted message, and the out queue, pending forever.
+         */
+        process_post(&mqtt_process, mqtt_do_publish_event, conn);
       }
     }
   }
@@ -1423,6 +1598,10 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
              uint8_t *payload, uint32_t payload_size,
              mqtt_qos_level_t qos_level, mqtt_retain_t retain)
 {
+#if MQTT_MAX_INFLIGHT > 1
+  struct mqtt_inflight *entry = NULL;
+#endif /* MQTT_MAX_INFLIGHT > 1 */
+
   if(conn->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
     return MQTT_STATUS_NOT_CONNECTED_ERROR;
   }
@@ -1434,10 +1613,31 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
     DBG("MQTT - Not accepted!\n");
     return MQTT_STATUS_OUT_QUEUE_FULL;
   }
+
+#if MQTT_MAX_INFLIGHT > 1
+  if(qos_level == MQTT_QOS_LEVEL_1) {
+    inflight_expire(conn);
+    entry = inflight_lookup(conn, 0);
+    if(entry == NULL) {
+      DBG("MQTT - Not accepted, window full!\n");
+      return MQTT_STATUS_OUT_QUEUE_FULL;
+    }
+  }
+#endif /* MQTT_MAX_INFLIGHT > 1 */
+
   conn->out_queue_full = 1;
   DBG("MQTT - Accepted!\n");
 
   conn->out_packet.mid = INCREMENT_MID(conn);
+  if(mid != NULL) {
+    *mid = conn->out_packet.mid;
+  }
+#if MQTT_MAX_INFLIGHT > 1
+  if(entry != NULL) {
+    entry->mid = conn->out_packet.mid;
+    entry->sent = clock_time();
+  }
+#endif /* MQTT_MAX_INFLIGHT > 1 */
   conn->out_packet.retain = retain;
   conn->out_packet.topic = topic;
   conn->out_packet.topic_length = strlen(topic);
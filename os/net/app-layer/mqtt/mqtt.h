@@ -117,6 +117,33 @@
 #define MQTT_PROTOCOL_NAME "MQIsdp"
 #define MQTT_TOPIC_MAX_LENGTH 128
 /*---------------------------------------------------------------------------*/
+/*
+ * When enabled, outgoing packets are written from the caller's topic and
+ * payload straight into the send space of the TCP socket, where they are
+ * queued behind any data still awaiting a TCP ACK, and incoming PUBLISH
+ * payload is handed to the application in place in the TCP input buffer.
+ * Otherwise, each packet is staged and sent only once the previous one has
+ * been acknowledged, and incoming payload is copied to the packet buffer.
+ */
+#ifdef MQTT_CONF_STREAMING
+#define MQTT_STREAMING MQTT_CONF_STREAMING
+#else
+#define MQTT_STREAMING 0
+#endif
+
+/*
+ * The number of QoS 1 PUBLISH messages that may await a PUBACK at the same
+ * time. With 1, mqtt_publish() is stop-and-wait: the next message is only
+ * accepted once the previous one has been acknowledged. Larger windows are
+ * only of use with MQTT_CONF_STREAMING, which lets packets be queued while
+ * earlier ones are in flight.
+ */
+#ifdef MQTT_CONF_MAX_INFLIGHT
+#define MQTT_MAX_INFLIGHT MQTT_CONF_MAX_INFLIGHT
+#else
+#define MQTT_MAX_INFLIGHT 1
+#endif
+/*---------------------------------------------------------------------------*/
 /*
  * Debug configuration, this is similar but not exactly like the Debugging
  * System discussion at https://github.com/contiki-os/contiki/wiki.
@@ -227,6 +254,7 @@ struct mqtt_message {
   uint32_t mid;
   char topic[MQTT_MAX_TOPIC_LENGTH + 1]; /* +1 for string termination */
 
+  /* Only valid for the duration of the MQTT_EVENT_PUBLISH callback */
   uint8_t *payload_chunk;
   uint16_t payload_chunk_length;
 
@@ -257,7 +285,7 @@ struct mqtt_in_packet {
   /* Not the same as payload in the MQTT sense, it also contains the variable
    * header.
    */
-  uint8_t payload_pos;
+  uint16_t payload_pos;
   uint8_t payload[MQTT_INPUT_BUFF_SIZE];
 
   /* Message specific data */
@@ -311,6 +339,14 @@ struct mqtt_credentials {
   struct mqtt_string password;
 };
 
+#if MQTT_MAX_INFLIGHT > 1
+/* A QoS 1 PUBLISH message that awaits its PUBACK. A mid of 0 is a free slot. */
+struct mqtt_inflight {
+  uint16_t mid;
+  clock_time_t sent;
+};
+#endif /* MQTT_MAX_INFLIGHT > 1 */
+
 struct mqtt_connection {
   /* Used by the list interface, must be first in the struct */
   struct mqtt_connection *next;
@@ -346,6 +382,9 @@ struct mqtt_connection {
   struct pt out_proto_thread;
   uint32_t out_write_pos;
   uint16_t max_segment_size;
+#if MQTT_MAX_INFLIGHT > 1
+  struct mqtt_inflight inflight[MQTT_MAX_INFLIGHT];
+#endif /* MQTT_MAX_INFLIGHT > 1 */
 
   /* Incoming data related */
   uint8_t in_buffer[MQTT_TCP_INPUT_BUFF_SIZE];
@@ -448,7 +487,14 @@ mqtt_status_t mqtt_unsubscribe(struct mqtt_connection *conn,
  *        subscriptions match its topic name
  * \return MQTT_STATUS_OK or some error status
  *
- * This function publishes to a topic on a MQTT broker.
+ * This function publishes to a topic on a MQTT broker. If \p mid is not NULL
+ * it is set to the message ID, which is also the data of the
+ * MQTT_EVENT_PUBACK event for QoS 1 messages.
+ *
+ * The topic and payload are not copied and must remain valid until the
+ * application is notified through mqtt_update_event. With MQTT_MAX_INFLIGHT
+ * larger than 1, MQTT_STATUS_OUT_QUEUE_FULL is returned for a QoS 1 message
+ * while that many messages await their PUBACK.
  */
 mqtt_status_t mqtt_publish(struct mqtt_connection *conn,
                            uint16_t *mid,
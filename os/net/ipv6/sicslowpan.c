@@ -256,8 +256,50 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* Reassemble each packet in a buffer of its own, with every fragment
+ * written at its offset in the packet as it arrives, in any order. The
+ * received 8-byte units are tracked in a bitmap, so that duplicate
+ * fragments are not counted twice. The SICSLOWPAN_REASS_CONTEXTS
+ * contexts then each hold a whole packet, and the fragment buffers
+ * are not used.
+ **/
+#ifdef SICSLOWPAN_CONF_REASS_DIRECT
+#define SICSLOWPAN_REASS_DIRECT SICSLOWPAN_CONF_REASS_DIRECT
+#else
+#define SICSLOWPAN_REASS_DIRECT 0
+#endif
+
+#if SICSLOWPAN_REASS_DIRECT
+#define SICSLOWPAN_REASS_BUF_SIZE (UIP_BUFSIZE - UIP_LLH_LEN)
+#define SICSLOWPAN_REASS_UNITS    ((SICSLOWPAN_REASS_BUF_SIZE + 7) / 8)
+#endif /* SICSLOWPAN_REASS_DIRECT */
+
+/* Forward the fragments of the packets that are routed through this
+ * node as they arrive, without reassembling the packets (RFC 8930).
+ * The header is uncompressed from the first fragment to find the next
+ * hop, and the fragments that follow are switched to it with a
+ * (previous hop, tag) -> (next hop, tag) entry. Packets that need
+ * more than a hop-by-hop update of their headers are reassembled.
+ **/
+#if defined(SICSLOWPAN_CONF_FRAG_FORWARDING) && UIP_CONF_ROUTER
+#define SICSLOWPAN_FRAG_FORWARDING SICSLOWPAN_CONF_FRAG_FORWARDING
+#else
+#define SICSLOWPAN_FRAG_FORWARDING 0
+#endif
+
+/* The number of packets that can be forwarded at the same time */
+#ifdef SICSLOWPAN_CONF_VRB_ENTRIES
+#define SICSLOWPAN_VRB_ENTRIES SICSLOWPAN_CONF_VRB_ENTRIES
+#else
+#define SICSLOWPAN_VRB_ENTRIES 4
+#endif
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
+#if SICSLOWPAN_REASS_DIRECT
+  /** The packet being reassembled, first for alignment */
+  uint8_t buf[SICSLOWPAN_REASS_BUF_SIZE];
+#endif /* SICSLOWPAN_REASS_DIRECT */
   /** When reassembling, the source address of the fragments being merged */
   linkaddr_t sender;
   /** The destination address of the fragments being merged */
@@ -271,15 +313,146 @@ struct sicslowpan_frag_info {
   /** Reassembly %process %timer. */
   struct timer reass_timer;
 
+#if SICSLOWPAN_REASS_DIRECT
+  /** The 8-byte units of the packet that have been received */
+  uint8_t received[(SICSLOWPAN_REASS_UNITS + 7) / 8];
+#else /* SICSLOWPAN_REASS_DIRECT */
   /** Fragment size of first fragment */
   uint16_t first_frag_len;
   /** First fragment - needs a larger buffer since the size is uncompressed size
    and we need to know total size to know when we have received last fragment. */
   uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+#endif /* SICSLOWPAN_REASS_DIRECT */
 };
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
+#if SICSLOWPAN_FRAG_FORWARDING
+/* A packet whose fragments are forwarded (virtual reassembly buffer) */
+struct sicslowpan_vrb {
+  /** The previous hop */
+  linkaddr_t sender;
+  /** The next hop */
+  linkaddr_t next_hop;
+  /** The tag of the fragments from the previous hop */
+  uint16_t tag;
+  /** The tag of the fragments to the next hop */
+  uint16_t out_tag;
+  /** The size of the packet, 0 if the entry is unused */
+  uint16_t len;
+  /** The number of bytes forwarded */
+  uint16_t forwarded_len;
+  /** Lifetime of the entry */
+  struct timer lifetime;
+};
+
+static struct sicslowpan_vrb vrb_table[SICSLOWPAN_VRB_ENTRIES];
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
+#if SICSLOWPAN_REASS_DIRECT
+/*---------------------------------------------------------------------------*/
+static void
+clear_fragments(uint8_t frag_info_index)
+{
+  frag_info[frag_info_index].len = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Mark the bytes of a fragment as received, and return 1 if this
+   completes the packet. */
+static int
+mark_fragment(uint8_t index, uint16_t offset, uint16_t len)
+{
+  struct sicslowpan_frag_info *info = &frag_info[index];
+  uint16_t unit;
+  uint16_t end;
+
+  /* The last fragment may be followed by extraneous bytes. */
+  end = MIN(offset + len, info->len);
+  for(unit = offset >> 3; unit < (end + 7) >> 3; unit++) {
+    if(!(info->received[unit >> 3] & (1 << (unit & 7)))) {
+      info->received[unit >> 3] |= 1 << (unit & 7);
+      info->reassembled_len += 8;
+    }
+  }
+  return info->reassembled_len >= info->len;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy the payload of a subsequent fragment to its place in the packet */
+static int
+store_fragment(uint8_t index, uint8_t offset)
+{
+  struct sicslowpan_frag_info *info = &frag_info[index];
+  uint16_t start;
+  uint16_t len;
+
+  start = (uint16_t)offset << 3;
+  if(start >= info->len) {
+    return -1;
+  }
+  len = MIN(packetbuf_datalen() - packetbuf_hdr_len, info->len - start);
+  memcpy(info->buf + start, packetbuf_ptr + packetbuf_hdr_len, len);
+  mark_fragment(index, start, len);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+/* Find the reassembly context of a fragment, or start a new one. The
+   fragments may come in any order, so that the first fragment does not
+   always start the reassembly. */
+static int8_t
+add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+{
+  int i;
+  int8_t found = -1;
+  int8_t unused = -1;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+      clear_fragments(i);
+    }
+    if(frag_info[i].len == 0) {
+      if(unused < 0) {
+        unused = i;
+      }
+    } else if(found < 0 && frag_info[i].tag == tag &&
+              frag_info[i].len == frag_size &&
+              linkaddr_cmp(&frag_info[i].sender,
+                           packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      found = i;
+    }
+  }
+
+  if(found < 0) {
+    if(unused < 0 || frag_size == 0 || frag_size > SICSLOWPAN_REASS_BUF_SIZE) {
+      LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+      return -1;
+    }
+    found = unused;
+    frag_info[found].len = frag_size;
+    frag_info[found].tag = tag;
+    frag_info[found].reassembled_len = 0;
+    memset(frag_info[found].received, 0, sizeof(frag_info[found].received));
+    linkaddr_copy(&frag_info[found].sender,
+                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
+    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  }
+
+  /* The first fragment is uncompressed into the buffer by the caller */
+  if(offset > 0 && store_fragment(found, offset) < 0) {
+    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", tag);
+    return -1;
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy the reassembled packet into uip */
+static void
+copy_frags2uip(int context)
+{
+  memcpy((uint8_t *)UIP_IP_BUF, frag_info[context].buf, frag_info[context].len);
+  clear_fragments(context);
+}
+#else /* SICSLOWPAN_REASS_DIRECT */
+
 struct sicslowpan_frag_buf {
   /* the index of the frag_info */
   uint8_t index;
@@ -436,6 +609,7 @@ copy_frags2uip(int context)
   /* deallocate all the fragments for this context */
   clear_fragments(context);
 }
+#endif /* SICSLOWPAN_REASS_DIRECT */
 #endif /* SICSLOWPAN_CONF_FRAG */
 
 /* -------------------------------------------------------------------------- */
@@ -503,6 +677,36 @@ addr_contexts[SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS];
 /** pointer to an address context. */
 static struct sicslowpan_addr_context *context;
 
+/* Remember how the last addresses were compressed: with which context,
+ * and how much of their IID could be elided against the link-layer
+ * address they were compared with. The cache has
+ * SICSLOWPAN_ADDR_CACHE_SIZE entries, indexed by a hash of both
+ * addresses. The contexts are also indexed by number for
+ * uncompression.
+ **/
+#ifdef SICSLOWPAN_CONF_ADDR_CACHE_SIZE
+#define SICSLOWPAN_ADDR_CACHE_SIZE SICSLOWPAN_CONF_ADDR_CACHE_SIZE
+#else
+#define SICSLOWPAN_ADDR_CACHE_SIZE 0
+#endif
+
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+struct sicslowpan_addr_cache {
+  uip_ipaddr_t ipaddr;
+  uip_lladdr_t lladdr;
+  /** The context of the address, NULL if none */
+  struct sicslowpan_addr_context *context;
+  /** The SAM/DAM mode of the IID, if there is a context */
+  uint8_t mode;
+  uint8_t used;
+};
+
+static struct sicslowpan_addr_cache addr_cache[SICSLOWPAN_ADDR_CACHE_SIZE];
+
+/** The contexts by number */
+static struct sicslowpan_addr_context *contexts_by_number[16];
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
+
 /** pointer to the byte where to write next inline field. */
 static uint8_t *hc06_ptr;
 
@@ -560,8 +764,10 @@ addr_context_lookup_by_prefix(uip_ipaddr_t *ipaddr)
 static struct sicslowpan_addr_context*
 addr_context_lookup_by_number(uint8_t number)
 {
-/* Remove code to avoid warnings and save flash if no context is used */
-#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+  return contexts_by_number[number & 0x0f];
+#elif SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  /* Remove code to avoid warnings and save flash if no context is used */
   int i;
   for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
     if((addr_contexts[i].used == 1) &&
@@ -573,23 +779,66 @@ addr_context_lookup_by_number(uint8_t number)
   return NULL;
 }
 /*--------------------------------------------------------------------*/
+/** \brief find how much of the IID of an address can be elided */
 static uint8_t
-compress_addr_64(uint8_t bitpos, uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
+iid_mode(uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
 {
   if(uip_is_addr_mac_addr_based(ipaddr, lladdr)) {
-    return 3 << bitpos; /* 0-bits */
+    return 3; /* 0-bits */
   } else if(sicslowpan_is_iid_16_bit_compressable(ipaddr)) {
+    return 2; /* 16-bits */
+  } else {
+    return 1; /* 64-bits */
+  }
+}
+/*--------------------------------------------------------------------*/
+static uint8_t
+compress_iid(uint8_t bitpos, uint8_t mode, uip_ipaddr_t *ipaddr)
+{
+  if(mode == 2) {
     /* compress IID to 16 bits xxxx::0000:00ff:fe00:XXXX */
     memcpy(hc06_ptr, &ipaddr->u16[7], 2);
     hc06_ptr += 2;
-    return 2 << bitpos; /* 16-bits */
-  } else {
+  } else if(mode == 1) {
     /* do not compress IID => xxxx::IID */
     memcpy(hc06_ptr, &ipaddr->u16[4], 8);
     hc06_ptr += 8;
-    return 1 << bitpos; /* 64-bits */
   }
+  return mode << bitpos;
+}
+/*--------------------------------------------------------------------*/
+static uint8_t
+compress_addr_64(uint8_t bitpos, uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
+{
+  return compress_iid(bitpos, iid_mode(ipaddr, lladdr), ipaddr);
 }
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+/*--------------------------------------------------------------------*/
+/** \brief find how an address is compressed against a link-layer
+    address, from the cache or by looking it up */
+static struct sicslowpan_addr_cache *
+addr_cache_lookup(uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
+{
+  struct sicslowpan_addr_cache *entry;
+
+  entry = &addr_cache[(ipaddr->u8[15] ^ ipaddr->u8[7] ^
+                       lladdr->addr[UIP_LLADDR_LEN - 1]) %
+                      SICSLOWPAN_ADDR_CACHE_SIZE];
+  if(entry->used && uip_ipaddr_cmp(&entry->ipaddr, ipaddr) &&
+     memcmp(&entry->lladdr, lladdr, UIP_LLADDR_LEN) == 0) {
+    return entry;
+  }
+
+  uip_ipaddr_copy(&entry->ipaddr, ipaddr);
+  memcpy(&entry->lladdr, lladdr, UIP_LLADDR_LEN);
+  entry->context = addr_context_lookup_by_prefix(ipaddr);
+  if(entry->context != NULL) {
+    entry->mode = iid_mode(ipaddr, lladdr);
+  }
+  entry->used = 1;
+  return entry;
+}
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
 
 /*-------------------------------------------------------------------- */
 /* Uncompress addresses based on a prefix and a postfix with zeroes in
@@ -674,6 +923,11 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
 {
   uint8_t tmp, iphc0, iphc1, *next_hdr, *next_nhc;
   int ext_hdr_len;
+  struct sicslowpan_addr_context *src_context, *dest_context;
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+  struct sicslowpan_addr_cache *cache;
+  uint8_t src_mode, dest_mode = 0;
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
   struct uip_udp_hdr *udp_buf;
 
   if(LOG_DBG_ENABLED) {
@@ -721,11 +975,28 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
    */
 
 
-  /* check if dest context exists (for allocating third byte) */
-  /* TODO: fix this so that it remembers the looked up values for
-     avoiding two lookups - or set the lookup values immediately */
-  if(addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr) != NULL ||
-     addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr) != NULL) {
+  /* Look up the contexts once (also for allocating third byte) */
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+  /* The destination may take the slot of the source: copy the source
+     entry out before looking the destination up */
+  cache = addr_cache_lookup(&UIP_IP_BUF->srcipaddr, &uip_lladdr);
+  src_context = cache->context;
+  src_mode = cache->mode;
+  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
+    /* Not compressed against a link-layer address, and not worth an
+       entry that unicast destinations could use */
+    dest_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
+  } else {
+    cache = addr_cache_lookup(&UIP_IP_BUF->destipaddr,
+                              (uip_lladdr_t *)link_destaddr);
+    dest_context = cache->context;
+    dest_mode = cache->mode;
+  }
+#else /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
+  src_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr);
+  dest_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
+  if(dest_context != NULL || src_context != NULL) {
     /* set context flag and increase hc06_ptr */
     LOG_DBG("compression: dest or src ipaddr - setting CID\n");
     iphc1 |= SICSLOWPAN_IPHC_CID;
@@ -817,17 +1088,21 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     LOG_DBG("compression: addr unspecified - setting SAC\n");
     iphc1 |= SICSLOWPAN_IPHC_SAC;
     iphc1 |= SICSLOWPAN_IPHC_SAM_00;
-  } else if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr))
-     != NULL) {
+  } else if(src_context != NULL) {
     /* elide the prefix - indicate by CID and set context + SAC */
     LOG_DBG("compression: src with context - setting CID & SAC ctx: %d\n",
-           context->number);
+           src_context->number);
     iphc1 |= SICSLOWPAN_IPHC_CID | SICSLOWPAN_IPHC_SAC;
-    PACKETBUF_IPHC_BUF[2] |= context->number << 4;
+    PACKETBUF_IPHC_BUF[2] |= src_context->number << 4;
     /* compession compare with this nodes address (source) */
 
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+    iphc1 |= compress_iid(SICSLOWPAN_IPHC_SAM_BIT, src_mode,
+                          &UIP_IP_BUF->srcipaddr);
+#else /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
     iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_SAM_BIT,
                               &UIP_IP_BUF->srcipaddr, &uip_lladdr);
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
     /* No context found for this address */
   } else if(uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) &&
             UIP_IP_BUF->destipaddr.u16[1] == 0 &&
@@ -871,15 +1146,20 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     }
   } else {
     /* Address is unicast, try to compress */
-    if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr)) != NULL) {
+    if(dest_context != NULL) {
       /* elide the prefix */
       iphc1 |= SICSLOWPAN_IPHC_DAC;
-      PACKETBUF_IPHC_BUF[2] |= context->number;
+      PACKETBUF_IPHC_BUF[2] |= dest_context->number;
       /* compession compare with link adress (destination) */
 
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0
+      iphc1 |= compress_iid(SICSLOWPAN_IPHC_DAM_BIT, dest_mode,
+                            &UIP_IP_BUF->destipaddr);
+#else /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
       iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_DAM_BIT,
                                 &UIP_IP_BUF->destipaddr,
                                 (uip_lladdr_t *)link_destaddr);
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 */
       /* No context found for this address */
     } else if(uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) &&
               UIP_IP_BUF->destipaddr.u16[1] == 0 &&
@@ -1536,6 +1816,33 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
 /*--------------------------------------------------------------------*/
+/**
+ * \brief Compress the headers of the IP packet in uip_buf into packetbuf
+ * \param dest the link layer destination address of the packet
+ * \return 1 if success, 0 otherwise
+ */
+static int
+compress_hdr(linkaddr_t *dest)
+{
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
+  compress_hdr_ipv6(dest);
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
+  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
+  (non link-local). */
+  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
+    add_paging_dispatch(1);
+    add_6lorh_hdr();
+  }
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
+  if(compress_hdr_iphc(dest) == 0) {
+    return 0;
+  }
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
+  return 1;
+}
+/*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
  *  network using 6lowpan.
  *  \param localdest The MAC address of the destination
@@ -1597,23 +1904,10 @@ output(const linkaddr_t *localdest)
   mac_max_payload = MAC_MAX_PAYLOAD - framer_hdrlen;
 
   /* Try to compress the headers */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
-  compress_hdr_ipv6(&dest);
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
-  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
-  (non link-local). */
-  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
-    add_paging_dispatch(1);
-    add_6lorh_hdr();
-  }
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
-#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
-  if(compress_hdr_iphc(&dest) == 0) {
+  if(compress_hdr(&dest) == 0) {
     /* Warning should already be issued by function above */
     return 0;
   }
-#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
 
   /* Calculate NETSTACK_FRAMER's header length, that will be added in the NETSTACK_MAC.
    * We calculate it here only to make a better decision of whether the outgoing packet
@@ -1761,6 +2055,270 @@ output(const linkaddr_t *localdest)
   return 1;
 }
 
+#if SICSLOWPAN_FRAG_FORWARDING
+/*--------------------------------------------------------------------*/
+/* Find the forwarding entry of a received fragment */
+static struct sicslowpan_vrb *
+vrb_lookup(uint16_t tag, uint16_t frag_size)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb_table[i].len > 0 && timer_expired(&vrb_table[i].lifetime)) {
+      vrb_table[i].len = 0;
+    }
+    if(vrb_table[i].len == frag_size && vrb_table[i].tag == tag &&
+       linkaddr_cmp(&vrb_table[i].sender,
+                    packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      return &vrb_table[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+/* Check whether a received fragment belongs to a packet that is being
+   reassembled */
+static int
+is_reassembled(uint16_t tag, uint16_t frag_size)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len == frag_size && frag_info[i].tag == tag &&
+       !timer_expired(&frag_info[i].reass_timer) &&
+       linkaddr_cmp(&frag_info[i].sender,
+                    packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*--------------------------------------------------------------------*/
+/* Account for a forwarded fragment, and free the entry once the whole
+   packet has been forwarded. */
+static void
+vrb_forwarded(struct sicslowpan_vrb *vrb, uint16_t len)
+{
+  vrb->forwarded_len += len;
+  if(vrb->forwarded_len >= vrb->len) {
+    vrb->len = 0;
+  }
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forward a first fragment, whose headers and payload have been
+ * uncompressed in uip_buf, and start forwarding its packet.
+ * \param tag the tag of the fragment
+ * \param frag_size the size of the packet
+ * \param len the number of bytes uncompressed in uip_buf
+ * \return 1 if the fragment was forwarded, 0 if its packet is to be
+ * reassembled, -1 if the fragment is to be dropped
+ */
+static int
+vrb_forward_first(uint16_t tag, uint16_t frag_size, uint16_t len)
+{
+  struct sicslowpan_vrb *vrb;
+  struct uip_ext_hdr *hbh;
+  uip_ds6_route_t *route;
+  uip_ipaddr_t *nexthop;
+  const uip_lladdr_t *lladdr;
+  uint16_t hdr_len;
+  uint16_t payload_len;
+  int framer_hdrlen;
+  int frag1_payload;
+  int i;
+
+  /* Only the packets that uIP would forward as they are */
+  if(uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_loopback(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr) ||
+     UIP_IP_BUF->ttl <= 1 || frag_size > UIP_LINK_MTU) {
+    return 0;
+  }
+
+  /* The root may insert or remove routing headers, which would change
+     the offsets of the fragments. Only a RPL hop-by-hop option, which
+     is updated in place, is supported. */
+  if(NETSTACK_ROUTING.node_is_root() ||
+     UIP_IP_BUF->proto == UIP_PROTO_ROUTING) {
+    return 0;
+  }
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO) {
+    hbh = (struct uip_ext_hdr *)((uint8_t *)UIP_IP_BUF + UIP_IPH_LEN);
+    if(len < UIP_IPH_LEN + (hbh->len << 3) + 8 ||
+       ((uint8_t *)hbh)[2] != UIP_EXT_HDR_OPT_RPL) {
+      return 0;
+    }
+  }
+
+  if(is_reassembled(tag, frag_size)) {
+    /* Fragments of the packet were received before this one */
+    return 0;
+  }
+
+  vrb = NULL;
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb_table[i].len > 0 && timer_expired(&vrb_table[i].lifetime)) {
+      vrb_table[i].len = 0;
+    }
+    if(vrb_table[i].len == 0) {
+      vrb = &vrb_table[i];
+      break;
+    }
+  }
+  if(vrb == NULL) {
+    return 0;
+  }
+
+  /* Look for the next hop, as tcpip_ipv6_output() does. Packets to
+     neighbors that are not in the cache are reassembled, so that uIP
+     can resolve their address. */
+  if(uip_ds6_is_addr_onlink(&UIP_IP_BUF->destipaddr)) {
+    nexthop = &UIP_IP_BUF->destipaddr;
+  } else if((route = uip_ds6_route_lookup(&UIP_IP_BUF->destipaddr)) != NULL) {
+    nexthop = uip_ds6_route_nexthop(route);
+  } else {
+    nexthop = uip_ds6_defrt_choose();
+  }
+  if(nexthop == NULL ||
+     (lladdr = uip_ds6_nbr_lladdr_from_ipaddr(nexthop)) == NULL) {
+    return 0;
+  }
+
+  /* From now on, the headers in uip_buf are updated for the next hop */
+  uip_len = len;
+  uip_ext_len = 0;
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO &&
+     !NETSTACK_ROUTING.ext_header_hbh_update(2)) {
+    LOG_WARN("forward: hop-by-hop option error, dropping fragment\n");
+    uip_clear_buf();
+    return -1;
+  }
+  UIP_IP_BUF->ttl--;
+  if(!NETSTACK_ROUTING.ext_header_update() || uip_len != len) {
+    LOG_WARN("forward: header update error, dropping fragment\n");
+    uip_clear_buf();
+    return -1;
+  }
+  hdr_len = uncomp_hdr_len;
+  payload_len = len - hdr_len;
+
+  linkaddr_copy(&vrb->sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  linkaddr_copy(&vrb->next_hop, (const linkaddr_t *)lladdr);
+  vrb->tag = tag;
+  vrb->out_tag = my_tag++;
+  vrb->len = frag_size;
+  vrb->forwarded_len = 0;
+  timer_set(&vrb->lifetime, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+  /* Compress the headers for the next hop */
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  packetbuf_hdr_len = 0;
+  uncomp_hdr_len = 0;
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &vrb->next_hop);
+  framer_hdrlen = NETSTACK_FRAMER.length();
+  if(framer_hdrlen < 0) {
+    framer_hdrlen = MAC_MAX_HEADER;
+  }
+  mac_max_payload = MAC_MAX_PAYLOAD - framer_hdrlen;
+  if(compress_hdr(&vrb->next_hop) == 0 || uncomp_hdr_len != hdr_len) {
+    LOG_WARN("forward: failed to compress header, dropping fragment\n");
+    vrb->len = 0;
+    uip_clear_buf();
+    return -1;
+  }
+
+  /* The compressed headers may be larger than on the previous hop, as
+     they are elided against other link-layer addresses. The payload
+     that does not fit then goes in a subsequent fragment of its own. */
+  frag1_payload = (mac_max_payload - packetbuf_hdr_len - SICSLOWPAN_FRAG1_HDR_LEN) & 0xfffffff8;
+  if(frag1_payload < 0 || ((hdr_len + MIN(frag1_payload, payload_len)) & 7)) {
+    LOG_WARN("forward: compressed header does not fit first fragment\n");
+    vrb->len = 0;
+    uip_clear_buf();
+    return -1;
+  }
+  frag1_payload = MIN(frag1_payload, payload_len);
+
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | frag_size));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, vrb->out_tag);
+  packetbuf_payload_len = frag1_payload;
+
+  LOG_INFO("forward: first fragment (tag %d -> %d, payload %d) to ",
+           tag, vrb->out_tag, frag1_payload);
+  LOG_INFO_LLADDR(&vrb->next_hop);
+  LOG_INFO_("\n");
+
+  last_tx_status = MAC_TX_OK;
+  if(fragment_copy_payload_and_send(hdr_len, &vrb->next_hop) == 0) {
+    vrb->len = 0;
+    uip_clear_buf();
+    return -1;
+  }
+
+  if(frag1_payload < payload_len) {
+    packetbuf_hdr_len = SICSLOWPAN_FRAGN_HDR_LEN;
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+          ((SICSLOWPAN_DISPATCH_FRAGN << 8) | frag_size));
+    PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = (hdr_len + frag1_payload) >> 3;
+    packetbuf_payload_len = payload_len - frag1_payload;
+    if(fragment_copy_payload_and_send(hdr_len + frag1_payload,
+                                      &vrb->next_hop) == 0) {
+      vrb->len = 0;
+      uip_clear_buf();
+      return -1;
+    }
+  }
+
+  vrb_forwarded(vrb, len);
+  uip_clear_buf();
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forward a subsequent fragment, if its packet is forwarded
+ * \param tag the tag of the fragment
+ * \param frag_size the size of the packet
+ * \return 1 if the fragment was forwarded, 0 otherwise
+ */
+static int
+vrb_forward_next(uint16_t tag, uint16_t frag_size)
+{
+  struct sicslowpan_vrb *vrb;
+  uint8_t *frame;
+  uint16_t frame_len;
+
+  vrb = vrb_lookup(tag, frag_size);
+  if(vrb == NULL || packetbuf_datalen() < SICSLOWPAN_FRAGN_HDR_LEN) {
+    return 0;
+  }
+
+  /* Move the fragment to the start of packetbuf, which
+     packetbuf_clear() leaves in place, and switch its tag */
+  frame = packetbuf_ptr;
+  frame_len = packetbuf_datalen();
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  memmove(packetbuf_ptr, frame, frame_len);
+  packetbuf_set_datalen(frame_len);
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, vrb->out_tag);
+
+  LOG_INFO("forward: fragment (tag %d -> %d, offset %d)\n",
+           tag, vrb->out_tag, PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] << 3);
+
+  send_packet(&vrb->next_hop);
+  vrb_forwarded(vrb, frame_len - SICSLOWPAN_FRAGN_HDR_LEN);
+  return 1;
+}
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
 /*--------------------------------------------------------------------*/
 /** \brief Process a received 6lowpan packet.
  *
@@ -1831,6 +2389,11 @@ input(void)
       LOG_INFO("input: received first element of a fragmented packet (tag %d, len %d)\n",
              frag_tag, frag_size);
 
+#if SICSLOWPAN_FRAG_FORWARDING
+      /* The fragment is uncompressed in uip_buf, to decide whether it
+         is forwarded, and added to a reassembly context only if not */
+      frag_context = -1;
+#else /* SICSLOWPAN_FRAG_FORWARDING */
       /* Add the fragment to the fragmentation context */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
@@ -1839,7 +2402,12 @@ input(void)
         return;
       }
 
+#if SICSLOWPAN_REASS_DIRECT
+      buffer = frag_info[frag_context].buf;
+#else /* SICSLOWPAN_REASS_DIRECT */
       buffer = frag_info[frag_context].first_frag;
+#endif /* SICSLOWPAN_REASS_DIRECT */
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
@@ -1852,6 +2420,12 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(vrb_forward_next(frag_tag, frag_size)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -1957,10 +2531,42 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   if(frag_size > 0) {
+#if SICSLOWPAN_FRAG_FORWARDING
+    if(first_fragment != 0) {
+      if(vrb_forward_first(frag_tag, frag_size,
+                           uncomp_hdr_len + packetbuf_payload_len) != 0) {
+        /* Forwarded, or dropped */
+        return;
+      }
+      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
+      if(frag_context == -1) {
+        LOG_ERR("input: failed to allocate new reassembly context\n");
+        return;
+      }
+#if SICSLOWPAN_REASS_DIRECT
+      memcpy(frag_info[frag_context].buf, buffer,
+             uncomp_hdr_len + packetbuf_payload_len);
+#else /* SICSLOWPAN_REASS_DIRECT */
+      if(uncomp_hdr_len + packetbuf_payload_len > SICSLOWPAN_FIRST_FRAGMENT_SIZE) {
+        LOG_ERR("input: first fragment too large\n");
+        clear_fragments(frag_context);
+        return;
+      }
+      memcpy(frag_info[frag_context].first_frag, buffer,
+             uncomp_hdr_len + packetbuf_payload_len);
+#endif /* SICSLOWPAN_REASS_DIRECT */
+    }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
     /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
+#if SICSLOWPAN_REASS_DIRECT
+      /* The first fragment may also be the last one to arrive */
+      last_fragment = mark_fragment(frag_context, 0,
+                                    uncomp_hdr_len + packetbuf_payload_len);
+#else /* SICSLOWPAN_REASS_DIRECT */
       frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+#endif /* SICSLOWPAN_REASS_DIRECT */
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
@@ -2060,6 +2666,17 @@ sicslowpan_init(void)
   }
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 1 */
 
+#if SICSLOWPAN_ADDR_CACHE_SIZE > 0 && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  {
+    int i;
+    for(i = SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS - 1; i >= 0; i--) {
+      if(addr_contexts[i].used == 1) {
+        contexts_by_number[addr_contexts[i].number & 0x0f] = &addr_contexts[i];
+      }
+    }
+  }
+#endif /* SICSLOWPAN_ADDR_CACHE_SIZE > 0 && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+
 #endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPHC */
 
   /* We use the queuebuf module if fragmentation is enabled */
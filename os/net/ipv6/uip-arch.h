@@ -103,6 +103,19 @@ void uip_add32(uint8_t *op32, uint16_t op16);
  */
 uint16_t uip_chksum(uint16_t *data, uint16_t len);
 
+/**
+ * Add a buffer to a one's complement sum.
+ * When the platform defines UIP_ARCH_CHKSUM_ADD, the checksum functions
+ * of uIP sum the IPv6 pseudo-header and the payload with this function,
+ * e.g. to use instructions with carry.
+ * \param sum The sum so far, in host byte order.
+ * \param data A pointer to the buffer, of any alignment.
+ * \param len The length of the buffer. If odd, the last byte is summed
+ * as if followed by a zero byte.
+ * \return The 16-bit one's complement sum, in host byte order.
+ */
+uint16_t uip_arch_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
 /**
  * Calculate the IP header checksum of the packet header in uip_buf.
  *
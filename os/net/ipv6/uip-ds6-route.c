@@ -91,6 +91,30 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_INDEX
+#if (UIP_DS6_ROUTE_INDEX_BUCKETS & (UIP_DS6_ROUTE_INDEX_BUCKETS - 1)) != 0
+#error UIP_DS6_ROUTE_INDEX_BUCKETS must be a power of two
+#endif
+
+/* Host (/128) routes are chained in a hash table through their
+   index_next field. */
+static uip_ds6_route_t *host_routes[UIP_DS6_ROUTE_INDEX_BUCKETS];
+
+/* Shorter prefixes are kept in a path-compressed binary trie. A node
+   either holds a route, or is a branch point with two children. With
+   N prefixes, at most N leaves and N - 1 branch points are needed.
+   Duplicate routes for the same prefix are chained on the node through
+   their index_next field. */
+struct prefix_node {
+  struct prefix_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+MEMB(prefixnodememb, struct prefix_node, 2 * UIP_DS6_ROUTE_NB);
+static struct prefix_node *prefix_root;
+#endif /* UIP_DS6_ROUTE_INDEX */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -176,6 +200,11 @@ uip_ds6_route_init(void)
   list_init(routelist);
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
+#if UIP_DS6_ROUTE_INDEX
+  memb_init(&prefixnodememb);
+  memset(host_routes, 0, sizeof(host_routes));
+  prefix_root = NULL;
+#endif /* UIP_DS6_ROUTE_INDEX */
 #endif /* (UIP_MAX_ROUTES != 0) */
 
   memb_init(&defaultroutermemb);
@@ -186,6 +215,215 @@ uip_ds6_route_init(void)
 #endif
 }
 #if (UIP_MAX_ROUTES != 0)
+#if UIP_DS6_ROUTE_INDEX
+/*---------------------------------------------------------------------------*/
+static unsigned
+host_route_hash(const uip_ipaddr_t *addr)
+{
+  uint32_t h;
+  int i;
+
+  h = 0;
+  for(i = 0; i < 8; i++) {
+    h = (h * 31) + addr->u16[i];
+  }
+  h ^= h >> 16;
+  return (unsigned)(h ^ (h >> 8)) & (UIP_DS6_ROUTE_INDEX_BUCKETS - 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+addr_bit(const uip_ipaddr_t *addr, uint8_t bit)
+{
+  return (addr->u8[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of leading bits, up to max, that a and b share */
+static uint8_t
+common_prefix_length(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+                     uint8_t max)
+{
+  uint8_t i;
+  uint8_t diff;
+
+  for(i = 0; i < max; i += 8) {
+    diff = a->u8[i >> 3] ^ b->u8[i >> 3];
+    if(diff != 0) {
+      while((diff & 0x80) == 0) {
+        diff <<= 1;
+        i++;
+      }
+      return i < max ? i : max;
+    }
+  }
+  return max;
+}
+/*---------------------------------------------------------------------------*/
+static struct prefix_node *
+prefix_node_new(const uip_ipaddr_t *prefix, uint8_t length,
+                uip_ds6_route_t *route)
+{
+  struct prefix_node *n;
+
+  n = memb_alloc(&prefixnodememb);
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->length = length;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+index_add(uip_ds6_route_t *r)
+{
+  struct prefix_node **slot;
+  struct prefix_node *n;
+  struct prefix_node *branch;
+  uint8_t common;
+
+  if(r->length >= 128) {
+    unsigned h = host_route_hash(&r->ipaddr);
+    r->index_next = host_routes[h];
+    host_routes[h] = r;
+    return 1;
+  }
+
+  slot = &prefix_root;
+  while((n = *slot) != NULL) {
+    common = common_prefix_length(&r->ipaddr, &n->prefix,
+                                  MIN(r->length, n->length));
+    if(common == n->length) {
+      if(r->length == n->length) {
+        /* Branch point for exactly this prefix, or a duplicate route
+           which is chained in front of the existing one */
+        r->index_next = n->route;
+        n->route = r;
+        return 1;
+      }
+      slot = &n->child[addr_bit(&r->ipaddr, n->length)];
+      continue;
+    }
+
+    /* The new prefix diverges from, or is shorter than, this node */
+    r->index_next = NULL;
+    if(common == r->length) {
+      branch = prefix_node_new(&r->ipaddr, r->length, r);
+      if(branch == NULL) {
+        return 0;
+      }
+    } else {
+      struct prefix_node *leaf;
+      branch = prefix_node_new(&r->ipaddr, common, NULL);
+      leaf = prefix_node_new(&r->ipaddr, r->length, r);
+      if(branch == NULL || leaf == NULL) {
+        memb_free(&prefixnodememb, branch);
+        memb_free(&prefixnodememb, leaf);
+        return 0;
+      }
+      branch->child[addr_bit(&r->ipaddr, common)] = leaf;
+    }
+    branch->child[addr_bit(&n->prefix, common)] = n;
+    *slot = branch;
+    return 1;
+  }
+
+  r->index_next = NULL;
+  *slot = prefix_node_new(&r->ipaddr, r->length, r);
+  return *slot != NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a route-less node that has at most one child, by splicing its
+   child (if any) into the slot that points at it. */
+static void
+prefix_node_collapse(struct prefix_node **slot)
+{
+  struct prefix_node *n = *slot;
+
+  if(n == NULL || n->route != NULL ||
+     (n->child[0] != NULL && n->child[1] != NULL)) {
+    return;
+  }
+  *slot = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&prefixnodememb, n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_rm(uip_ds6_route_t *r)
+{
+  struct prefix_node **parent_slot;
+  struct prefix_node **slot;
+  struct prefix_node *n;
+  uip_ds6_route_t **p;
+
+  if(r->length >= 128) {
+    for(p = &host_routes[host_route_hash(&r->ipaddr)];
+        *p != NULL; p = &(*p)->index_next) {
+      if(*p == r) {
+        *p = r->index_next;
+        break;
+      }
+    }
+    return;
+  }
+
+  parent_slot = NULL;
+  slot = &prefix_root;
+  while((n = *slot) != NULL && n->length < r->length) {
+    parent_slot = slot;
+    slot = &n->child[addr_bit(&r->ipaddr, n->length)];
+  }
+  if(n == NULL || n->length != r->length ||
+     common_prefix_length(&r->ipaddr, &n->prefix, n->length) != n->length) {
+    return;
+  }
+
+  for(p = &n->route; *p != NULL; p = &(*p)->index_next) {
+    if(*p == r) {
+      *p = r->index_next;
+      break;
+    }
+  }
+  if(n->route != NULL) {
+    return;
+  }
+  prefix_node_collapse(slot);
+  if(parent_slot != NULL) {
+    prefix_node_collapse(parent_slot);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+index_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *found_route;
+  struct prefix_node *n;
+
+  /* A host route is always the longest match */
+  for(r = host_routes[host_route_hash(addr)];
+      r != NULL; r = r->index_next) {
+    if(uip_ipaddr_cmp(addr, &r->ipaddr)) {
+      return r;
+    }
+  }
+
+  found_route = NULL;
+  for(n = prefix_root; n != NULL;
+      n = n->child[addr_bit(addr, n->length)]) {
+    if(common_prefix_length(addr, &n->prefix, n->length) != n->length) {
+      break;
+    }
+    if(n->route != NULL) {
+      found_route = n->route;
+    }
+    if(n->length >= 128) {
+      break;
+    }
+  }
+  return found_route;
+}
+#endif /* UIP_DS6_ROUTE_INDEX */
 /*---------------------------------------------------------------------------*/
 static uip_lladdr_t *
 uip_ds6_route_nexthop_lladdr(uip_ds6_route_t *route)
@@ -266,9 +504,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_INDEX
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_INDEX */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -278,6 +518,9 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_INDEX
+  found_route = index_lookup(addr);
+#else /* UIP_DS6_ROUTE_INDEX */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -293,6 +536,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_INDEX */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -304,6 +548,10 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the index, lookups do not depend on the list order, so the
+     list only needs to be kept in LRU order when eviction relies on
+     it. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -313,6 +561,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -456,6 +705,13 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#if UIP_DS6_ROUTE_INDEX
+  if(!index_add(r)) {
+    /* This should not happen, the trie is sized for a full table. */
+    LOG_ERR("Add: could not index route\n");
+  }
+#endif /* UIP_DS6_ROUTE_INDEX */
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -500,6 +756,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_INDEX
+    index_rm(route);
+#endif /* UIP_DS6_ROUTE_INDEX */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,24 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index the routing table for faster lookups. When enabled,
+ *  /128 host routes are kept in a hash table and shorter prefixes in a
+ *  path-compressed binary trie, so that uip_ds6_route_lookup() no longer
+ *  scans the whole route list. Costs one pointer per route plus
+ *  2 * UIP_DS6_ROUTE_NB trie nodes of RAM. */
+#ifdef UIP_CONF_DS6_ROUTE_INDEX
+#define UIP_DS6_ROUTE_INDEX UIP_CONF_DS6_ROUTE_INDEX
+#else /* UIP_CONF_DS6_ROUTE_INDEX */
+#define UIP_DS6_ROUTE_INDEX 0
+#endif /* UIP_CONF_DS6_ROUTE_INDEX */
+
+/** \brief Number of hash buckets for host routes, must be a power of two */
+#ifdef UIP_CONF_DS6_ROUTE_INDEX_BUCKETS
+#define UIP_DS6_ROUTE_INDEX_BUCKETS UIP_CONF_DS6_ROUTE_INDEX_BUCKETS
+#else /* UIP_CONF_DS6_ROUTE_INDEX_BUCKETS */
+#define UIP_DS6_ROUTE_INDEX_BUCKETS 64
+#endif /* UIP_CONF_DS6_ROUTE_INDEX_BUCKETS */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -177,6 +195,10 @@ typedef struct uip_ds6_route {
      uses. */
   struct uip_ds6_route_neighbor_routes *neighbor_routes;
   uip_ipaddr_t ipaddr;
+#if UIP_DS6_ROUTE_INDEX
+  /* Next route in the same host route hash bucket */
+  struct uip_ds6_route *index_next;
+#endif /* UIP_DS6_ROUTE_INDEX */
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
 #endif
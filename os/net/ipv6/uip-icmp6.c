@@ -111,6 +111,13 @@ uip_icmp6_register_input_handler(uip_icmp6_input_handler_t *handler)
 static void
 echo_request_input(void)
 {
+#if UIP_CONF_IPV6_CHECKS
+  /* The fields of the request that the reply changes */
+  uip_ipaddr_t request_addrs[2];
+  uint8_t request_type[2];
+  uint16_t chksum;
+#endif /* UIP_CONF_IPV6_CHECKS */
+
   /*
    * we send an echo reply. It is trivial if there was no extension
    * headers in the request otherwise we need to remove the extension
@@ -122,6 +129,13 @@ echo_request_input(void)
   LOG_INFO_6ADDR(&UIP_IP_BUF->destipaddr);
   LOG_INFO_("\n");
 
+#if UIP_CONF_IPV6_CHECKS
+  memcpy(request_addrs, &UIP_IP_BUF->srcipaddr, sizeof(request_addrs));
+  request_type[0] = UIP_ICMP_BUF->type;
+  request_type[1] = UIP_ICMP_BUF->icode;
+  chksum = UIP_ICMP_BUF->icmpchksum;
+#endif /* UIP_CONF_IPV6_CHECKS */
+
   /* IP header */
   UIP_IP_BUF->ttl = uip_ds6_if.cur_hop_limit;
 
@@ -158,8 +172,18 @@ echo_request_input(void)
   /* Note: now UIP_ICMP_BUF points to the beginning of the echo reply */
   UIP_ICMP_BUF->type = ICMP6_ECHO_REPLY;
   UIP_ICMP_BUF->icode = 0;
+#if UIP_CONF_IPV6_CHECKS
+  /* The checksum of the request was verified, and the reply only changes
+     the addresses and the type: update it instead of summing the payload */
+  chksum = uip_chksum_update(chksum, request_addrs, &UIP_IP_BUF->srcipaddr,
+                             sizeof(request_addrs));
+  chksum = uip_chksum_update(chksum, request_type, &UIP_ICMP_BUF->type,
+                             sizeof(request_type));
+  UIP_ICMP_BUF->icmpchksum = chksum;
+#else /* UIP_CONF_IPV6_CHECKS */
   UIP_ICMP_BUF->icmpchksum = 0;
   UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+#endif /* UIP_CONF_IPV6_CHECKS */
 
   LOG_INFO("Sending Echo Reply to ");
   LOG_INFO_6ADDR(&UIP_IP_BUF->destipaddr);
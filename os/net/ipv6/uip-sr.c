@@ -46,6 +46,8 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 
+#include <string.h>
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "IPv6 SR"
@@ -58,6 +60,29 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_NODE_HASH_SIZE
+#if (UIP_SR_NODE_HASH_SIZE & (UIP_SR_NODE_HASH_SIZE - 1)) != 0
+#error UIP_SR_NODE_HASH_SIZE must be a power of two
+#endif
+/* The nodes, chained in buckets by link identifier */
+static uip_sr_node_t *node_buckets[UIP_SR_NODE_HASH_SIZE];
+#endif /* UIP_SR_NODE_HASH_SIZE */
+
+#if UIP_SR_PATH_CACHE_SIZE
+#if (UIP_SR_PATH_CACHE_SIZE & (UIP_SR_PATH_CACHE_SIZE - 1)) != 0
+#error UIP_SR_PATH_CACHE_SIZE must be a power of two
+#endif
+/* Source routes, one per slot, by link identifier of the destination */
+static uip_sr_path_t path_cache[UIP_SR_PATH_CACHE_SIZE];
+/* Incremented whenever a path of the graph may have changed, i.e. when the
+   parent of a node changes or a node is removed. Cached routes of an older
+   version are stale */
+static uint32_t graph_version;
+#define GRAPH_CHANGED() graph_version++
+#else /* UIP_SR_PATH_CACHE_SIZE */
+#define GRAPH_CHANGED()
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,6 +90,46 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_NODE_HASH_SIZE || UIP_SR_PATH_CACHE_SIZE
+static unsigned
+link_identifier_hash(const unsigned char *link_identifier)
+{
+  unsigned h = 0;
+  int i;
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + link_identifier[i];
+  }
+  return h ^ (h >> 8);
+}
+#endif /* UIP_SR_NODE_HASH_SIZE || UIP_SR_PATH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
+#if UIP_SR_NODE_HASH_SIZE
+static uip_sr_node_t **
+node_bucket(const unsigned char *link_identifier)
+{
+  return &node_buckets[link_identifier_hash(link_identifier)
+                       & (UIP_SR_NODE_HASH_SIZE - 1)];
+}
+#endif /* UIP_SR_NODE_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
+static void
+node_remove(uip_sr_node_t *node)
+{
+#if UIP_SR_NODE_HASH_SIZE
+  uip_sr_node_t **p;
+  for(p = node_bucket(node->link_identifier); *p != NULL; p = &(*p)->hash_next) {
+    if(*p == node) {
+      *p = node->hash_next;
+      break;
+    }
+  }
+#endif /* UIP_SR_NODE_HASH_SIZE */
+  list_remove(nodelist, node);
+  memb_free(&nodememb, node);
+  num_nodes--;
+  GRAPH_CHANGED();
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t *addr)
 {
@@ -81,12 +146,25 @@ uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_NODE_HASH_SIZE
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = *node_bucket(addr->u8 + 8); l != NULL; l = l->hash_next) {
+    /* Compare node identifier, then prefix */
+    if(memcmp(l->link_identifier, addr->u8 + 8, 8) == 0
+       && node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_NODE_HASH_SIZE */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_NODE_HASH_SIZE */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -125,6 +203,9 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+#if UIP_SR_PATH_CACHE_SIZE
+  uip_sr_node_t *prev_parent_node;
+#endif /* UIP_SR_PATH_CACHE_SIZE */
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -150,7 +231,15 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
     child_node->parent = NULL;
     list_add(nodelist, child_node);
     num_nodes++;
+#if UIP_SR_NODE_HASH_SIZE
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+    child_node->hash_next = *node_bucket(child_node->link_identifier);
+    *node_bucket(child_node->link_identifier) = child_node;
+#endif /* UIP_SR_NODE_HASH_SIZE */
   }
+#if UIP_SR_PATH_CACHE_SIZE
+  prev_parent_node = child_node->parent;
+#endif /* UIP_SR_PATH_CACHE_SIZE */
 
   /* Initialize node */
   child_node->graph = graph;
@@ -173,6 +262,13 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
     child_node->parent = parent_node;
   }
 
+#if UIP_SR_PATH_CACHE_SIZE
+  if(child_node->parent != prev_parent_node) {
+    /* The routes through the node changed */
+    GRAPH_CHANGED();
+  }
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -188,6 +284,12 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_NODE_HASH_SIZE
+  memset(node_buckets, 0, sizeof(node_buckets));
+#endif /* UIP_SR_NODE_HASH_SIZE */
+#if UIP_SR_PATH_CACHE_SIZE
+  memset(path_cache, 0, sizeof(path_cache));
+#endif /* UIP_SR_PATH_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -202,6 +304,36 @@ uip_sr_node_next(uip_sr_node_t *item)
   return list_item_next(item);
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_PATH_CACHE_SIZE
+static uip_sr_path_t *
+path_cache_slot(const uip_sr_node_t *dest)
+{
+  return &path_cache[link_identifier_hash(dest->link_identifier)
+                     & (UIP_SR_PATH_CACHE_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+const uip_sr_path_t *
+uip_sr_path_cache_lookup(const uip_sr_node_t *dest, const uip_ipaddr_t *addr)
+{
+  const uip_sr_path_t *path = path_cache_slot(dest);
+  if(path->dest == dest && path->version == graph_version
+     && uip_ipaddr_cmp(&path->dest_ipaddr, addr)) {
+    return path;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+uip_sr_path_t *
+uip_sr_path_cache_add(const uip_sr_node_t *dest, const uip_ipaddr_t *addr)
+{
+  uip_sr_path_t *path = path_cache_slot(dest);
+  path->dest = dest;
+  uip_ipaddr_copy(&path->dest_ipaddr, addr);
+  path->version = graph_version;
+  return path;
+}
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 void
 uip_sr_periodic(unsigned seconds)
 {
@@ -226,9 +358,7 @@ uip_sr_periodic(unsigned seconds)
         LOG_INFO_("\n");
       }
       /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      node_remove(l);
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -242,9 +372,7 @@ uip_sr_free_all(void)
   uip_sr_node_t *next;
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
-    list_remove(nodelist, l);
-    memb_free(&nodememb, l);
-    num_nodes--;
+    node_remove(l);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -85,6 +85,30 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Number of buckets of the node index, keyed by link identifier. 0 to look
+   up the nodes with a scan of the node list. Must be a power of two */
+#ifdef UIP_SR_CONF_NODE_HASH_SIZE
+#define UIP_SR_NODE_HASH_SIZE UIP_SR_CONF_NODE_HASH_SIZE
+#else /* UIP_SR_CONF_NODE_HASH_SIZE */
+#define UIP_SR_NODE_HASH_SIZE 0
+#endif /* UIP_SR_CONF_NODE_HASH_SIZE */
+
+/* Number of source routes cached, by destination. 0 to disable the cache.
+   Must be a power of two */
+#ifdef UIP_SR_CONF_PATH_CACHE_SIZE
+#define UIP_SR_PATH_CACHE_SIZE UIP_SR_CONF_PATH_CACHE_SIZE
+#else /* UIP_SR_CONF_PATH_CACHE_SIZE */
+#define UIP_SR_PATH_CACHE_SIZE 0
+#endif /* UIP_SR_CONF_PATH_CACHE_SIZE */
+
+/* Room for the compressed hop addresses of a cached source route. Longer
+   routes are not cached */
+#ifdef UIP_SR_CONF_PATH_CACHE_ADDR_LEN
+#define UIP_SR_PATH_CACHE_ADDR_LEN UIP_SR_CONF_PATH_CACHE_ADDR_LEN
+#else /* UIP_SR_CONF_PATH_CACHE_ADDR_LEN */
+#define UIP_SR_PATH_CACHE_ADDR_LEN 64
+#endif /* UIP_SR_CONF_PATH_CACHE_ADDR_LEN */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -98,8 +122,30 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_NODE_HASH_SIZE
+  /* Next node in the same bucket of the node index */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_NODE_HASH_SIZE */
 } uip_sr_node_t;
 
+/** \brief A source route from the root to a destination, as inserted in
+ * the source routing header of the packets to the destination */
+typedef struct uip_sr_path {
+  /* The destination node and its address */
+  const uip_sr_node_t *dest;
+  uip_ipaddr_t dest_ipaddr;
+  /* The first hop, i.e. the node whose parent is the root */
+  uip_ipaddr_t next_hop;
+  /* Version of the graph the route was computed from */
+  uint32_t version;
+  /* Number of addresses in the route, and bytes elided from each */
+  uint8_t path_len;
+  uint8_t cmpr;
+  /* The addresses, from the second hop to the destination, without
+     their first cmpr bytes */
+  uint8_t addr[UIP_SR_PATH_CACHE_ADDR_LEN];
+} uip_sr_path_t;
+
 /********** Public functions **********/
 
 /**
@@ -162,6 +208,30 @@ uip_sr_node_t *uip_sr_get_node(void *graph, const uip_ipaddr_t *addr);
 */
 int uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr);
 
+#if UIP_SR_PATH_CACHE_SIZE
+/**
+ * Looks up the cached source route to a node. Routes computed before the
+ * last change of parent or removal of a node are not returned
+ *
+ * \param dest The destination node
+ * \param addr The IPv6 global address of the destination
+ * \return The source route, or NULL if none is cached
+*/
+const uip_sr_path_t *uip_sr_path_cache_lookup(const uip_sr_node_t *dest,
+                                              const uip_ipaddr_t *addr);
+
+/**
+ * Allocates an entry of the source route cache, replacing the route
+ * that it holds, if any. The caller fills in the route
+ *
+ * \param dest The destination node
+ * \param addr The IPv6 global address of the destination
+ * \return The entry, with dest, dest_ipaddr and version set
+*/
+uip_sr_path_t *uip_sr_path_cache_add(const uip_sr_node_t *dest,
+                                     const uip_ipaddr_t *addr);
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
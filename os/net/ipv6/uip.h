@@ -2248,6 +2248,27 @@ extern uip_lladdr_t uip_lladdr;
  */
 uint16_t uip_chksum(uint16_t *data, uint16_t len);
 
+/**
+ * Update an Internet checksum for a change of some of the data that it
+ * covers, without summing the rest of the data again.
+ *
+ * See RFC1624.
+ *
+ * \param chksum The checksum field, as found in the packet.
+ *
+ * \param old_data The changed data, before the change.
+ *
+ * \param new_data The changed data, after the change.
+ *
+ * \param len The length of the changed data. Must be even, and the data
+ * must start at an even offset in the data covered by the checksum.
+ *
+ * \return The checksum field for the new data. As for a full
+ * computation, a UDP checksum of 0 must be sent as 0xffff.
+ */
+uint16_t uip_chksum_update(uint16_t chksum, const void *old_data,
+                           const void *new_data, uint16_t len);
+
 /**
  * Calculate the IP header checksum of the packet header in uip_buf.
  *
@@ -81,6 +81,8 @@
 #include "net/ipv6/multicast/uip-mcast6.h"
 #include "net/routing/routing.h"
 
+#include <string.h>
+
 #if UIP_ND6_SEND_NS
 #include "net/ipv6/uip-ds6-nbr.h"
 #endif /* UIP_ND6_SEND_NS */
@@ -298,6 +300,53 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
+#if UIP_ARCH_CHKSUM_ADD
+#define chksum uip_arch_chksum_add
+#elif UIP_CHKSUM_WIDE
+static uint16_t
+chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  /* The one's complement sum does not depend on the byte order (RFC 1071):
+     sum the words in the byte order of the CPU, and swap the result */
+  uint64_t acc = uip_htons(sum);
+  uint32_t w[4];
+  uint16_t t;
+
+  while(len >= sizeof(w)) {
+    memcpy(w, data, sizeof(w));
+    acc += (uint64_t)w[0] + w[1] + w[2] + w[3];
+    data += sizeof(w);
+    len -= sizeof(w);
+  }
+  while(len >= 4) {
+    memcpy(w, data, 4);
+    acc += w[0];
+    data += 4;
+    len -= 4;
+  }
+  if(len >= 2) {
+    memcpy(&t, data, 2);
+    acc += t;
+    data += 2;
+    len -= 2;
+  }
+  if(len == 1) {
+    /* The last byte, followed by a zero byte */
+    t = 0;
+    memcpy(&t, data, 1);
+    acc += t;
+  }
+
+  /* Fold the carries back into 16 bits */
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  /* Return sum in host byte order. */
+  return uip_ntohs((uint16_t)acc);
+}
+#else /* UIP_CHKSUM_WIDE */
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
@@ -328,6 +377,7 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
   /* Return sum in host byte order. */
   return sum;
 }
+#endif /* UIP_CHKSUM_WIDE */
 /*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
@@ -404,6 +454,23 @@ uip_udpchksum(void)
 #endif /* UIP_UDP && UIP_UDP_CHECKSUMS */
 #endif /* UIP_ARCH_CHKSUM */
 /*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update(uint16_t chksum, const void *old_data, const void *new_data,
+                  uint16_t len)
+{
+  uint32_t sum;
+
+  /* HC' = ~(~HC + ~m + m'), as per RFC 1624. The sum of the complements
+     of the old words is the complement of their sum */
+  sum = (uint16_t)~uip_ntohs(chksum);
+  sum += (uint16_t)~uip_ntohs(uip_chksum((uint16_t *)old_data, len));
+  sum += uip_ntohs(uip_chksum((uint16_t *)new_data, len));
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+
+  return uip_htons((uint16_t)~sum);
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_init(void)
 {
@@ -613,6 +613,22 @@ void uip_log(char *msg);
 #define UIP_BYTE_ORDER     (UIP_LITTLE_ENDIAN)
 #endif /* UIP_CONF_BYTE_ORDER */
 
+/**
+ * Compute the Internet checksum 32 bits at a time, in a 64-bit
+ * accumulator, instead of 16 bits at a time. Faster on 32-bit and
+ * 64-bit CPUs, larger on 8-bit and 16-bit ones.
+ *
+ * Platforms can instead provide uip_arch_chksum_add() by defining
+ * UIP_ARCH_CHKSUM_ADD, see uip-arch.h.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CHKSUM_WIDE
+#define UIP_CHKSUM_WIDE    (UIP_CONF_CHKSUM_WIDE)
+#else /* UIP_CONF_CHKSUM_WIDE */
+#define UIP_CHKSUM_WIDE    0
+#endif /* UIP_CONF_CHKSUM_WIDE */
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 
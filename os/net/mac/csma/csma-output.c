@@ -49,6 +49,7 @@
 #include "net/netstack.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "net/nbr-table.h"
 
 #if CONTIKI_TARGET_COOJA
 #include "lib/simEnvChange.h"
@@ -90,6 +91,22 @@
 #define CSMA_MAX_FRAME_RETRIES 7
 #endif
 
+/* Index the neighbor queues by the link-layer address of the neighbor
+   table, instead of scanning the list of queues for each packet */
+#ifdef CSMA_CONF_WITH_NBR_QUEUE_INDEX
+#define CSMA_WITH_NBR_QUEUE_INDEX CSMA_CONF_WITH_NBR_QUEUE_INDEX
+#else
+#define CSMA_WITH_NBR_QUEUE_INDEX 0
+#endif
+
+/* Maximum number of packets sent back-to-back to a neighbor, without
+   a new backoff, after a successful transmission. 0 to disable */
+#ifdef CSMA_CONF_TX_BATCH_MAX_LEN
+#define CSMA_TX_BATCH_MAX_LEN CSMA_CONF_TX_BATCH_MAX_LEN
+#else
+#define CSMA_TX_BATCH_MAX_LEN 0
+#endif
+
 /* Packet metadata */
 struct qbuf_metadata {
   mac_callback_t sent;
@@ -104,6 +121,9 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
+#if CSMA_WITH_NBR_QUEUE_INDEX
+  uint8_t indexed;
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
   LIST_STRUCT(packet_queue);
 };
 
@@ -135,13 +155,96 @@ MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
 
+#if CSMA_WITH_NBR_QUEUE_INDEX
+/* The queue of each neighbor, in the neighbor table. The queues to
+   broadcast, or to a neighbor that could not be added to the table,
+   are only in the list, and counted in unindexed_count */
+NBR_TABLE(struct neighbor_queue *, neighbor_queue_index);
+static uint8_t unindexed_count;
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
+
+#if CSMA_TX_BATCH_MAX_LEN
+/* Set while transmit_from_queue() can send the next packet right away */
+static uint8_t batch_active;
+/* The neighbor to send the next packet of the batch to, if any */
+static struct neighbor_queue *batch_next;
+#endif /* CSMA_TX_BATCH_MAX_LEN */
+
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_from_queue(void *ptr);
 /*---------------------------------------------------------------------------*/
+#if CSMA_WITH_NBR_QUEUE_INDEX
+static void
+neighbor_queue_index_removed(struct neighbor_queue **item)
+{
+  /* The neighbor table evicted the entry, the queue is only in the list */
+  if(*item != NULL && (*item)->indexed) {
+    (*item)->indexed = 0;
+    unindexed_count++;
+  }
+}
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_add(struct neighbor_queue *n)
+{
+  list_add(neighbor_list, n);
+#if CSMA_WITH_NBR_QUEUE_INDEX
+  n->indexed = 0;
+  if(!linkaddr_cmp(&n->addr, &linkaddr_null)) {
+    struct neighbor_queue **item;
+    item = nbr_table_add_lladdr(neighbor_queue_index, &n->addr,
+                                NBR_TABLE_REASON_MAC, NULL);
+    if(item != NULL) {
+      *item = n;
+      /* Keep the entry as long as packets are queued */
+      nbr_table_lock(neighbor_queue_index, item);
+      n->indexed = 1;
+    }
+  }
+  if(!n->indexed) {
+    unindexed_count++;
+  }
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+#if CSMA_WITH_NBR_QUEUE_INDEX
+  if(n->indexed) {
+    struct neighbor_queue **item;
+    item = nbr_table_get_from_lladdr(neighbor_queue_index, &n->addr);
+    if(item != NULL) {
+      nbr_table_remove(neighbor_queue_index, item);
+    }
+  } else {
+    unindexed_count--;
+  }
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
+  list_remove(neighbor_list, n);
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
+  struct neighbor_queue *n;
+
+#if CSMA_WITH_NBR_QUEUE_INDEX
+  if(!linkaddr_cmp(addr, &linkaddr_null)) {
+    struct neighbor_queue **item;
+    item = nbr_table_get_from_lladdr(neighbor_queue_index, addr);
+    if(item != NULL) {
+      return *item;
+    }
+    if(unindexed_count == 0) {
+      return NULL;
+    }
+  }
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
+
+  n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
       return n;
@@ -166,15 +269,23 @@ backoff_period(void)
 }
 /*---------------------------------------------------------------------------*/
 static int
+create_frame(void)
+{
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+
+  return NETSTACK_FRAMER.create();
+}
+/*---------------------------------------------------------------------------*/
+static int
 send_one_packet(void *ptr)
 {
   int ret;
   int last_sent_ok = 0;
 
-  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
-  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
-
-  if(NETSTACK_FRAMER.create() < 0) {
+  /* With QUEUEBUF_ZERO_COPY, the frame was created when queued and the
+     packetbuf aliases it */
+  if(!QUEUEBUF_ZERO_COPY && create_frame() < 0) {
     /* Failed to allocate space for headers */
     LOG_ERR("failed to create packet\n");
     ret = MAC_TX_ERR_FATAL;
@@ -258,14 +369,17 @@ send_one_packet(void *ptr)
     last_sent_ok = 1;
   }
 
+#if QUEUEBUF_ZERO_COPY
+  /* The queuebuf may be freed from packet_sent() */
+  queuebuf_release_alias();
+#endif /* QUEUEBUF_ZERO_COPY */
   packet_sent(ptr, ret, 1);
   return last_sent_ok;
 }
 /*---------------------------------------------------------------------------*/
 static void
-transmit_from_queue(void *ptr)
+send_from_queue(struct neighbor_queue *n)
 {
-  struct neighbor_queue *n = ptr;
   if(n) {
     struct packet_queue *q = list_head(n->packet_queue);
     if(q != NULL) {
@@ -275,13 +389,39 @@ transmit_from_queue(void *ptr)
         queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
         n->transmissions, list_length(n->packet_queue));
       /* Send first packet in the neighbor queue */
+#if QUEUEBUF_ZERO_COPY
+      queuebuf_alias_to_packetbuf(q->buf);
+#else /* QUEUEBUF_ZERO_COPY */
       queuebuf_to_packetbuf(q->buf);
+#endif /* QUEUEBUF_ZERO_COPY */
       send_one_packet(n);
     }
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
+transmit_from_queue(void *ptr)
+{
+#if CSMA_TX_BATCH_MAX_LEN
+  struct neighbor_queue *n = ptr;
+  uint8_t count = 0;
+
+  /* After a successful transmission, free_packet() leaves the next packet
+     of the neighbor to us, and we send it without a new backoff. The
+     radio stays on, the channel is still checked before each packet */
+  do {
+    batch_next = NULL;
+    batch_active = ++count < CSMA_TX_BATCH_MAX_LEN;
+    send_from_queue(n);
+    n = batch_next;
+  } while(n != NULL);
+  batch_active = 0;
+#else /* CSMA_TX_BATCH_MAX_LEN */
+  send_from_queue(ptr);
+#endif /* CSMA_TX_BATCH_MAX_LEN */
+}
+/*---------------------------------------------------------------------------*/
+static void
 schedule_transmission(struct neighbor_queue *n)
 {
   clock_time_t delay;
@@ -317,13 +457,19 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_TX_BATCH_MAX_LEN
+      if(batch_active && status == MAC_TX_OK) {
+        /* Send the next packet back-to-back, from transmit_from_queue() */
+        batch_next = n;
+        return;
+      }
+#endif /* CSMA_TX_BATCH_MAX_LEN */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
     }
   }
 }
@@ -497,10 +643,22 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
-      list_add(neighbor_list, n);
+      neighbor_queue_add(n);
     }
   }
 
+#if QUEUEBUF_ZERO_COPY
+  /* Create the frame once, all transmissions send it from the queuebuf */
+  if(n != NULL && create_frame() < 0) {
+    LOG_ERR("failed to create packet\n");
+    if(list_length(n->packet_queue) == 0) {
+      neighbor_queue_free(n);
+    }
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+    return;
+  }
+#endif /* QUEUEBUF_ZERO_COPY */
+
   if(n != NULL) {
     /* Add packet to the neighbor's queue */
     if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
@@ -541,8 +699,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        neighbor_queue_free(n);
       }
     } else {
       LOG_WARN("Neighbor queue full\n");
@@ -560,5 +717,9 @@ csma_output_init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+#if CSMA_WITH_NBR_QUEUE_INDEX
+  nbr_table_register(neighbor_queue_index,
+                     (nbr_table_callback *)neighbor_queue_index_removed);
+#endif /* CSMA_WITH_NBR_QUEUE_INDEX */
   queuebuf_init();
 }
@@ -308,6 +308,31 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep the set of unicast neighbors that have packets, no Tx link and
+ * an expired backoff, and the set of neighbors in backoff, so that
+ * shared slots only look at these neighbors instead of all of them */
+#ifdef TSCH_QUEUE_CONF_WITH_ACTIVE_SET
+#define TSCH_QUEUE_WITH_ACTIVE_SET TSCH_QUEUE_CONF_WITH_ACTIVE_SET
+#else
+#define TSCH_QUEUE_WITH_ACTIVE_SET 0
+#endif
+
+/* Queue the control packets (EBs and ICMPv6, e.g. RPL) to every
+ * neighbor apart from its data packets, and send them first */
+#ifdef TSCH_QUEUE_CONF_WITH_PRIORITIES
+#define TSCH_QUEUE_WITH_PRIORITIES TSCH_QUEUE_CONF_WITH_PRIORITIES
+#else
+#define TSCH_QUEUE_WITH_PRIORITIES 0
+#endif
+
+/* The maximum number of outgoing control packets towards each neighbor,
+ * with TSCH_QUEUE_WITH_PRIORITIES. Must be power of two */
+#ifdef TSCH_QUEUE_CONF_NUM_PRIO_PER_NEIGHBOR
+#define TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR TSCH_QUEUE_CONF_NUM_PRIO_PER_NEIGHBOR
+#else
+#define TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR 4
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -347,6 +372,15 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep an index of all links sorted by slotframe and timeslot, so that
+ * tsch_schedule_get_next_active_link() runs a binary search per slotframe
+ * instead of iterating over all links. Costs one pointer per link. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#define TSCH_SCHEDULE_WITH_LINK_INDEX TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_LINK_INDEX 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -53,6 +53,9 @@
 #include "lib/random.h"
 #include "net/queuebuf.h"
 #include "net/mac/tsch/tsch.h"
+#if TSCH_QUEUE_WITH_PRIORITIES && NETSTACK_CONF_WITH_IPV6
+#include "net/ipv6/uip.h"
+#endif /* TSCH_QUEUE_WITH_PRIORITIES && NETSTACK_CONF_WITH_IPV6 */
 #include <string.h>
 
 /* Log configuration */
@@ -65,6 +68,16 @@
 #error TSCH_QUEUE_NUM_PER_NEIGHBOR must be power of two
 #endif
 
+#if TSCH_QUEUE_WITH_PRIORITIES
+#if (TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR & (TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR - 1)) != 0
+#error TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR must be power of two
+#endif
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+
+#if TSCH_QUEUE_WITH_ACTIVE_SET && TSCH_QUEUE_MAX_NEIGHBOR_QUEUES > 255
+#error TSCH_QUEUE_WITH_ACTIVE_SET supports up to 255 neighbor queues
+#endif
+
 /* We have as many packets are there are queuebuf in the system */
 MEMB(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
 MEMB(neighbor_memb, struct tsch_neighbor, TSCH_QUEUE_MAX_NEIGHBOR_QUEUES);
@@ -74,6 +87,162 @@ LIST(neighbor_list);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+/* A set of neighbors, stored in an array. Each neighbor keeps its
+ * position in the array, so that it is added and removed in O(1).
+ * The sets are only modified from the slot operation, or with the
+ * TSCH lock held. */
+#define NOT_IN_SET 0xff
+struct nbr_set {
+  struct tsch_neighbor *nbrs[TSCH_QUEUE_MAX_NEIGHBOR_QUEUES];
+  uint8_t count;
+  uint8_t id; /* index in set_index of the neighbors */
+};
+
+/* The unicast neighbors with no Tx link, packets and an expired
+ * backoff: the candidates of tsch_queue_get_unicast_packet_for_any.
+ * Neighbors that are no longer ready are removed lazily. */
+static struct nbr_set active_set = { .id = 0 };
+/* The neighbors with a backoff window, possibly already elapsed */
+static struct nbr_set backoff_set = { .id = 1 };
+
+/* Neighbors that may have become ready outside of the slot operation,
+ * e.g. when a packet was queued to them. The slot operation adds them
+ * to the active set. Must be power of two */
+#define ACTIVE_UPDATES_NUM 8
+static struct tsch_neighbor *active_updates_array[ACTIVE_UPDATES_NUM];
+static struct ringbufindex active_updates;
+/* Set when active_updates is full, or when neighbors may have become
+ * ready otherwise: all neighbors are then checked */
+static volatile uint8_t active_rescan;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
+
+/*---------------------------------------------------------------------------*/
+/* Returns the first packet of a neighbor queue, control packets first */
+static struct tsch_packet *
+peek_packet(const struct tsch_neighbor *n)
+{
+  int16_t get_index;
+#if TSCH_QUEUE_WITH_PRIORITIES
+  get_index = ringbufindex_peek_get(&n->tx_ringbuf_prio);
+  if(get_index != -1) {
+    return n->tx_array_prio[get_index];
+  }
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+  get_index = ringbufindex_peek_get(&n->tx_ringbuf);
+  if(get_index != -1) {
+    return n->tx_array[get_index];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+queue_is_empty(const struct tsch_neighbor *n)
+{
+#if TSCH_QUEUE_WITH_PRIORITIES
+  if(!ringbufindex_empty(&n->tx_ringbuf_prio)) {
+    return 0;
+  }
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+  return ringbufindex_empty(&n->tx_ringbuf);
+}
+#if TSCH_QUEUE_WITH_PRIORITIES
+/*---------------------------------------------------------------------------*/
+/* Is the packet in packetbuf a control packet? */
+static int
+packetbuf_is_control(void)
+{
+  if(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) == FRAME802154_BEACONFRAME) {
+    return 1;
+  }
+#if NETSTACK_CONF_WITH_IPV6
+  /* 6LoWPAN sets the network ID to the upper-layer protocol */
+  if(packetbuf_attr(PACKETBUF_ATTR_NETWORK_ID) == UIP_PROTO_ICMP6) {
+    return 1;
+  }
+#endif /* NETSTACK_CONF_WITH_IPV6 */
+  return 0;
+}
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+/*---------------------------------------------------------------------------*/
+static void
+nbr_set_add(struct nbr_set *s, struct tsch_neighbor *n)
+{
+  if(n->set_index[s->id] == NOT_IN_SET) {
+    n->set_index[s->id] = s->count;
+    s->nbrs[s->count++] = n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_set_remove(struct nbr_set *s, struct tsch_neighbor *n)
+{
+  uint8_t i = n->set_index[s->id];
+  if(i != NOT_IN_SET) {
+    /* Move the last neighbor of the set in place of n */
+    s->count--;
+    s->nbrs[i] = s->nbrs[s->count];
+    s->nbrs[i]->set_index[s->id] = i;
+    n->set_index[s->id] = NOT_IN_SET;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* May the neighbor send over a shared link without being linked to? */
+static int
+nbr_is_active(const struct tsch_neighbor *n)
+{
+  return !n->is_broadcast && n->tx_links_count == 0
+    && n->backoff_window == 0 && !queue_is_empty(n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+active_set_update(struct tsch_neighbor *n)
+{
+  if(nbr_is_active(n)) {
+    nbr_set_add(&active_set, n);
+  } else {
+    nbr_set_remove(&active_set, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Have the slot operation check a neighbor for the active set */
+static void
+active_set_notify(struct tsch_neighbor *n)
+{
+  int16_t put_index = ringbufindex_peek_put(&active_updates);
+  if(put_index != -1) {
+    active_updates_array[put_index] = n;
+    ringbufindex_put(&active_updates);
+  } else {
+    active_rescan = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Add the neighbors notified outside of the slot operation */
+static void
+active_set_refresh(void)
+{
+  int16_t get_index;
+  while((get_index = ringbufindex_peek_get(&active_updates)) != -1) {
+    active_set_update(active_updates_array[get_index]);
+    ringbufindex_get(&active_updates);
+  }
+  if(active_rescan) {
+    struct tsch_neighbor *n;
+    active_rescan = 0;
+    for(n = list_head(neighbor_list); n != NULL; n = list_item_next(n)) {
+      active_set_update(n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_queue_tx_links_updated(void)
+{
+  active_rescan = 1;
+}
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -90,6 +259,13 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         /* Initialize neighbor entry */
         memset(n, 0, sizeof(struct tsch_neighbor));
         ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
+#if TSCH_QUEUE_WITH_PRIORITIES
+        ringbufindex_init(&n->tx_ringbuf_prio, TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR);
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+        n->set_index[active_set.id] = NOT_IN_SET;
+        n->set_index[backoff_set.id] = NOT_IN_SET;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
         linkaddr_copy(&n->addr, addr);
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
@@ -211,6 +387,13 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
 
       /* Remove neighbor from list */
       list_remove(neighbor_list, n);
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+      /* The slot operation is not running: take the pending
+       * notifications, which may point at n, and remove n from the sets */
+      active_set_refresh();
+      nbr_set_remove(&active_set, n);
+      nbr_set_remove(&backoff_set, n);
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
 
       tsch_release_lock();
 
@@ -231,10 +414,20 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
   struct tsch_neighbor *n = NULL;
   int16_t put_index = -1;
   struct tsch_packet *p = NULL;
+  struct ringbufindex *tx_ringbuf;
+  struct tsch_packet **tx_array;
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      put_index = ringbufindex_peek_put(&n->tx_ringbuf);
+      tx_ringbuf = &n->tx_ringbuf;
+      tx_array = n->tx_array;
+#if TSCH_QUEUE_WITH_PRIORITIES
+      if(packetbuf_is_control()) {
+        tx_ringbuf = &n->tx_ringbuf_prio;
+        tx_array = n->tx_array_prio;
+      }
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+      put_index = ringbufindex_peek_put(tx_ringbuf);
       if(put_index != -1) {
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
@@ -250,8 +443,16 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             p->transmissions = 0;
             p->max_transmissions = max_transmissions;
             /* Add to ringbuf (actual add committed through atomic operation) */
-            n->tx_array[put_index] = p;
-            ringbufindex_put(&n->tx_ringbuf);
+            tx_array[put_index] = p;
+            ringbufindex_put(tx_ringbuf);
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+            /* If the neighbor is in backoff, the slot operation will
+             * add it when its backoff expires */
+            if(nbr_is_active(n)
+               && n->set_index[active_set.id] == NOT_IN_SET) {
+              active_set_notify(n);
+            }
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -281,12 +482,27 @@ tsch_queue_packet_count(const linkaddr_t *addr)
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      return ringbufindex_elements(&n->tx_ringbuf);
+      return tsch_queue_nbr_packet_count(n);
     }
   }
   return -1;
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the number of packets currently in a neighbor queue */
+int
+tsch_queue_nbr_packet_count(const struct tsch_neighbor *n)
+{
+  if(n == NULL) {
+    return -1;
+  }
+#if TSCH_QUEUE_WITH_PRIORITIES
+  return ringbufindex_elements(&n->tx_ringbuf_prio)
+    + ringbufindex_elements(&n->tx_ringbuf);
+#else /* TSCH_QUEUE_WITH_PRIORITIES */
+  return ringbufindex_elements(&n->tx_ringbuf);
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
 /* Remove first packet from a neighbor queue */
 struct tsch_packet *
 tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
@@ -294,7 +510,14 @@ tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
   if(!tsch_is_locked()) {
     if(n != NULL) {
       /* Get and remove packet from ringbuf (remove committed through an atomic operation */
-      int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
+      int16_t get_index;
+#if TSCH_QUEUE_WITH_PRIORITIES
+      get_index = ringbufindex_get(&n->tx_ringbuf_prio);
+      if(get_index != -1) {
+        return n->tx_array_prio[get_index];
+      }
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+      get_index = ringbufindex_get(&n->tx_ringbuf);
       if(get_index != -1) {
         return n->tx_array[get_index];
       } else {
@@ -315,6 +538,23 @@ tsch_queue_free_packet(struct tsch_packet *p)
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Remove a packet that was at the head of a neighbor queue. A control
+ * packet may have been queued in front of it in the meantime. */
+static void
+remove_sent_packet(struct tsch_neighbor *n, struct tsch_packet *p)
+{
+#if TSCH_QUEUE_WITH_PRIORITIES
+  int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf_prio);
+  if(get_index != -1 && n->tx_array_prio[get_index] == p) {
+    ringbufindex_get(&n->tx_ringbuf_prio);
+  } else {
+    ringbufindex_get(&n->tx_ringbuf);
+  }
+#else /* TSCH_QUEUE_WITH_PRIORITIES */
+  tsch_queue_remove_packet_from_queue(n);
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
 /* Updates neighbor queue state after a transmission */
 int
 tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
@@ -326,7 +566,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
 
   if(mac_tx_status == MAC_TX_OK) {
     /* Successful transmission */
-    tsch_queue_remove_packet_from_queue(n);
+    remove_sent_packet(n, p);
     in_queue = 0;
 
     /* Update CSMA state in the unicast case */
@@ -341,7 +581,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     /* Failed transmission */
     if(p->transmissions >= p->max_transmissions) {
       /* Drop packet */
-      tsch_queue_remove_packet_from_queue(n);
+      remove_sent_packet(n, p);
       in_queue = 0;
     }
     /* Update CSMA state in the unicast case */
@@ -355,6 +595,13 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     }
   }
 
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+  if(n->backoff_window != 0) {
+    nbr_set_add(&backoff_set, n);
+  }
+  active_set_update(n);
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
+
   return in_queue;
 }
 /*---------------------------------------------------------------------------*/
@@ -373,6 +620,10 @@ tsch_queue_reset(void)
       tsch_queue_backoff_reset(n);
       n = next_n;
     }
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+    /* Backoffs were reset outside of the slot operation */
+    active_rescan = 1;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -400,7 +651,7 @@ tsch_queue_free_unused_neighbors(void)
 int
 tsch_queue_is_empty(const struct tsch_neighbor *n)
 {
-  return !tsch_is_locked() && n != NULL && ringbufindex_empty(&n->tx_ringbuf);
+  return !tsch_is_locked() && n != NULL && queue_is_empty(n);
 }
 /*---------------------------------------------------------------------------*/
 /* Returns the first packet from a neighbor queue */
@@ -410,13 +661,13 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
   if(!tsch_is_locked()) {
     int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
     if(n != NULL) {
-      int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
-      if(get_index != -1 &&
+      struct tsch_packet *p = peek_packet(n);
+      if(p != NULL &&
           !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
                                                                     make sure the backoff has expired */
 #if TSCH_WITH_LINK_SELECTOR
-        int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
-        int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
+        int packet_attr_slotframe = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
+        int packet_attr_timeslot = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
         if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
           return NULL;
         }
@@ -424,7 +675,7 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
           return NULL;
         }
 #endif
-        return n->tx_array[get_index];
+        return p;
       }
     }
   }
@@ -447,6 +698,27 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+    struct tsch_packet *p = NULL;
+    int i = 0;
+    active_set_refresh();
+    while(i < active_set.count) {
+      struct tsch_neighbor *curr_nbr = active_set.nbrs[i];
+      if(!nbr_is_active(curr_nbr)) {
+        /* Remove it, the last neighbor of the set takes its place */
+        nbr_set_remove(&active_set, curr_nbr);
+        continue;
+      }
+      p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+      if(p != NULL) {
+        if(n != NULL) {
+          *n = curr_nbr;
+        }
+        return p;
+      }
+      i++;
+    }
+#else /* TSCH_QUEUE_WITH_ACTIVE_SET */
     struct tsch_neighbor *curr_nbr = list_head(neighbor_list);
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
@@ -462,6 +734,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       }
       curr_nbr = list_item_next(curr_nbr);
     }
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
   }
   return NULL;
 }
@@ -502,6 +775,24 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+    int i = 0;
+    while(i < backoff_set.count) {
+      struct tsch_neighbor *n = backoff_set.nbrs[i];
+      if(n->backoff_window != 0
+         && ((n->tx_links_count == 0 && is_broadcast)
+             || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, &n->addr)))) {
+        n->backoff_window--;
+      }
+      if(n->backoff_window == 0) {
+        /* Backoff expired (or was reset), the neighbor may be active */
+        nbr_set_remove(&backoff_set, n);
+        active_set_update(n);
+        continue;
+      }
+      i++;
+    }
+#else /* TSCH_QUEUE_WITH_ACTIVE_SET */
     struct tsch_neighbor *n = list_head(neighbor_list);
     while(n != NULL) {
       if(n->backoff_window != 0 /* Is the queue in backoff state? */
@@ -511,6 +802,7 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
       }
       n = list_item_next(n);
     }
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -521,6 +813,12 @@ tsch_queue_init(void)
   list_init(neighbor_list);
   memb_init(&neighbor_memb);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+  active_set.count = 0;
+  backoff_set.count = 0;
+  ringbufindex_init(&active_updates, ACTIVE_UPDATES_NUM);
+  active_rescan = 0;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
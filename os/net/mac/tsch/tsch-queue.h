@@ -97,6 +97,13 @@ int tsch_queue_global_packet_count(void);
  * \return The number of packets in the neighbor's queue
  */
 int tsch_queue_packet_count(const linkaddr_t *addr);
+/**
+ * \brief Returns the number of packets currently in a neighbor queue,
+ * without looking the neighbor up
+ * \param n The neighbor queue
+ * \return The number of packets in the neighbor's queue, -1 if n is NULL
+ */
+int tsch_queue_nbr_packet_count(const struct tsch_neighbor *n);
 /**
  * \brief Remove first packet from a neighbor queue. The packet is stored in a separate
  * dequeued packet list, for later processing.
@@ -174,6 +181,13 @@ void tsch_queue_backoff_inc(struct tsch_neighbor *n);
  * \param dest_addr The target address, &tsch_broadcast_address for broadcast
  */
 void tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr);
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+/**
+ * \brief Notify the queue module that the Tx links of neighbors changed,
+ * so that the set of active neighbors is updated
+ */
+void tsch_queue_tx_links_updated(void);
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
 /**
  * \brief Initialize TSCH queue module
  */
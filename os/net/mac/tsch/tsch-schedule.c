@@ -67,6 +67,84 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+/* All links, sorted by slotframe handle then timeslot. Updated along with
+ * the slotframes' link lists, while holding the TSCH lock. */
+static struct tsch_link *sorted_links[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t num_sorted_links;
+
+/*---------------------------------------------------------------------------*/
+/* Returns the position of the first link that sorts after
+ * (slotframe_handle, timeslot), or that is equal to it if inclusive */
+static uint16_t
+link_index_search(uint16_t slotframe_handle, uint16_t timeslot, int inclusive)
+{
+  uint16_t low = 0;
+  uint16_t high = num_sorted_links;
+
+  while(low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    const struct tsch_link *l = sorted_links[mid];
+    if(l->slotframe_handle < slotframe_handle
+       || (l->slotframe_handle == slotframe_handle
+           && (l->timeslot < timeslot
+               || (!inclusive && l->timeslot == timeslot)))) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_index_add(struct tsch_link *l)
+{
+  uint16_t pos;
+
+  if(num_sorted_links >= TSCH_SCHEDULE_MAX_LINKS) {
+    return;
+  }
+  pos = link_index_search(l->slotframe_handle, l->timeslot, 1);
+  memmove(&sorted_links[pos + 1], &sorted_links[pos],
+          (num_sorted_links - pos) * sizeof(sorted_links[0]));
+  sorted_links[pos] = l;
+  num_sorted_links++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_index_remove(struct tsch_link *l)
+{
+  uint16_t pos;
+
+  pos = link_index_search(l->slotframe_handle, l->timeslot, 1);
+  if(pos < num_sorted_links && sorted_links[pos] == l) {
+    num_sorted_links--;
+    memmove(&sorted_links[pos], &sorted_links[pos + 1],
+            (num_sorted_links - pos) * sizeof(sorted_links[0]));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the link of a slotframe that occurs first after a timeslot,
+ * wrapping around to the first link of the slotframe if needed */
+static struct tsch_link *
+link_index_next(struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t pos;
+
+  pos = link_index_search(sf->handle, timeslot, 0);
+  if(pos < num_sorted_links && sorted_links[pos]->slotframe_handle == sf->handle) {
+    return sorted_links[pos];
+  }
+  /* No later link in this slotframe, wrap around */
+  pos = link_index_search(sf->handle, 0, 1);
+  if(pos < num_sorted_links && sorted_links[pos]->slotframe_handle == sf->handle) {
+    return sorted_links[pos];
+  }
+  return NULL;
+}
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -217,6 +295,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+        link_index_add(l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
 
         LOG_INFO("add_link %u %u %u %u %u ",
                slotframe->handle, link_options, link_type, timeslot, channel_offset);
@@ -233,6 +314,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
             if(!(l->link_options & LINK_OPTION_SHARED)) {
               n->dedicated_tx_links_count++;
             }
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+            tsch_queue_tx_links_updated();
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
           }
         }
       }
@@ -266,6 +350,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_("\n");
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      link_index_remove(l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -279,6 +366,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
           if(!(link_options & LINK_OPTION_SHARED)) {
             n->dedicated_tx_links_count--;
           }
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+          tsch_queue_tx_links_updated();
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
         }
       }
 
@@ -335,7 +425,13 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      /* There is max one link per timeslot, so only the first link after
+       * the current timeslot can be the earliest one of this slotframe */
+      struct tsch_link *l = link_index_next(sf, timeslot);
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
@@ -379,7 +475,11 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
           }
         }
 
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+        l = NULL;
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
         l = list_item_next(l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       }
       sf = list_item_next(sf);
     }
@@ -401,6 +501,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+    num_sorted_links = 0;
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     tsch_release_lock();
     return 1;
   } else {
@@ -169,6 +169,9 @@ static struct tsch_neighbor *current_neighbor = NULL;
 
 /* Indicates whether an extra link is needed to handle the current burst */
 static int burst_link_scheduled = 0;
+/* The neighbor we are sending the current burst to, NULL if we are
+ * receiving it */
+static struct tsch_neighbor *burst_neighbor = NULL;
 /* Counts the length of the current burst */
 int tsch_current_burst_count = 0;
 
@@ -477,7 +480,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       burst_link_requested = 0;
       if(!is_broadcast
              && tsch_current_burst_count + 1 < TSCH_BURST_MAX_LEN
-             && tsch_queue_packet_count(&current_neighbor->addr) > 1) {
+             && tsch_queue_nbr_packet_count(current_neighbor) > 1) {
         burst_link_requested = 1;
         tsch_packet_set_frame_pending(packet, packet_len);
       }
@@ -638,6 +641,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
                 the extra slot will be scheduled at the received */
                 if(burst_link_requested) {
                   burst_link_scheduled = 1;
+                  burst_neighbor = current_neighbor;
                 }
               } else {
                 mac_tx_status = MAC_TX_NOACK;
@@ -868,6 +872,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
                 /* Schedule a burst link iff the frame pending bit was set */
                 burst_link_scheduled = tsch_packet_get_frame_pending(current_input->payload, current_input->len);
+                burst_neighbor = NULL;
               }
             }
 
@@ -946,6 +951,9 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
                             tsch_lock_requested,
                             current_link == NULL);
       );
+      /* The burst neighbor does not wait for us beyond the next slot,
+       * and might be removed while TSCH is locked */
+      burst_link_scheduled = 0;
 
     } else {
       int is_active_slot;
@@ -954,13 +962,23 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
       /* Reset drift correction */
       drift_correction = 0;
       is_drift_correction_used = 0;
-      /* Get a packet ready to be sent */
-      current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
-      /* There is no packet to send, and this link does not have Rx flag. Instead of doing
-       * nothing, switch to the backup link (has Rx flag) if any. */
-      if(current_packet == NULL && !(current_link->link_options & LINK_OPTION_RX) && backup_link != NULL) {
-        current_link = backup_link;
+      if(burst_link_scheduled) {
+        /* The burst neighbor is on the current channel in this slot:
+         * send it the next packet of its queue, or listen to it. Any
+         * other packet, e.g. an EB on an advertising link, would be
+         * lost to it. */
+        current_neighbor = burst_neighbor;
+        current_packet = burst_neighbor != NULL ?
+          tsch_queue_get_packet_for_nbr(burst_neighbor, current_link) : NULL;
+      } else {
+        /* Get a packet ready to be sent */
         current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
+        /* There is no packet to send, and this link does not have Rx flag. Instead of doing
+         * nothing, switch to the backup link (has Rx flag) if any. */
+        if(current_packet == NULL && !(current_link->link_options & LINK_OPTION_RX) && backup_link != NULL) {
+          current_link = backup_link;
+          current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
+        }
       }
       is_active_slot = current_packet != NULL || (current_link->link_options & LINK_OPTION_RX);
       if(is_active_slot) {
@@ -122,6 +122,15 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_PRIORITIES
+  /* Array and circular buffer for the control packets, sent first */
+  struct tsch_packet *tx_array_prio[TSCH_QUEUE_NUM_PRIO_PER_NEIGHBOR];
+  struct ringbufindex tx_ringbuf_prio;
+#endif /* TSCH_QUEUE_WITH_PRIORITIES */
+#if TSCH_QUEUE_WITH_ACTIVE_SET
+  /* Position in the active and backoff sets of tsch-queue.c, 0xff if none */
+  uint8_t set_index[2];
+#endif /* TSCH_QUEUE_WITH_ACTIVE_SET */
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
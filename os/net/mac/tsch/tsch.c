@@ -855,6 +855,8 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
 PROCESS_THREAD(tsch_pending_events_process, ev, data)
 {
   PROCESS_BEGIN();
+  /* Serve the packets received and sent in the slots first */
+  process_set_priority(PROCESS_CURRENT(), PROCESS_PRIORITY_HIGH);
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
     tsch_rx_process_pending();
@@ -83,6 +83,23 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_LLADDR_HASH
+#if (NBR_TABLE_LLADDR_HASH_SIZE & (NBR_TABLE_LLADDR_HASH_SIZE - 1)) != 0 \
+  || NBR_TABLE_LLADDR_HASH_SIZE <= NBR_TABLE_MAX_NEIGHBORS
+#error NBR_TABLE_LLADDR_HASH_SIZE must be a power of two larger than NBR_TABLE_MAX_NEIGHBORS
+#endif
+#if NBR_TABLE_MAX_NEIGHBORS < 0xff
+typedef uint8_t lladdr_slot_t;
+#else
+typedef uint16_t lladdr_slot_t;
+#endif
+/* Open-addressing (linear probing) hash table, mapping link-layer
+ * addresses to neighbor indices. Kept in sync with nbr_table_keys.
+ * Slots hold the neighbor index plus one, zero meaning empty. */
+static lladdr_slot_t lladdr_slots[NBR_TABLE_LLADDR_HASH_SIZE];
+#define LLADDR_SLOT_EMPTY 0
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -125,17 +142,89 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
 {
   return key_from_index(index_from_item(table, item));
 }
+#if NBR_TABLE_WITH_LLADDR_HASH
+/*---------------------------------------------------------------------------*/
+/* Get the home slot of a link-layer address in the hash table */
+static unsigned
+lladdr_hash(const linkaddr_t *lladdr)
+{
+  unsigned h = 0;
+  int i;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = (h * 33) ^ lladdr->u8[i];
+  }
+  return (h ^ (h >> 7)) & (NBR_TABLE_LLADDR_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Get the slot that holds a link-layer address, or the empty slot
+ * where it would be inserted */
+static unsigned
+lladdr_slot_find(const linkaddr_t *lladdr)
+{
+  unsigned slot = lladdr_hash(lladdr);
+  while(lladdr_slots[slot] != LLADDR_SLOT_EMPTY
+        && !linkaddr_cmp(lladdr, &key_from_index(lladdr_slots[slot] - 1)->lladdr)) {
+    slot = (slot + 1) & (NBR_TABLE_LLADDR_HASH_SIZE - 1);
+  }
+  return slot;
+}
+/*---------------------------------------------------------------------------*/
+static void
+lladdr_slot_add(nbr_table_key_t *key)
+{
+  lladdr_slots[lladdr_slot_find(&key->lladdr)] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash table. Entries that follow in the same
+ * probe sequence are shifted back, so that no tombstones are needed. */
+static void
+lladdr_slot_remove(nbr_table_key_t *key)
+{
+  unsigned hole;
+  unsigned slot;
+  unsigned home;
+
+  hole = lladdr_slot_find(&key->lladdr);
+  if(lladdr_slots[hole] == LLADDR_SLOT_EMPTY) {
+    return;
+  }
+  slot = hole;
+  while(1) {
+    slot = (slot + 1) & (NBR_TABLE_LLADDR_HASH_SIZE - 1);
+    if(lladdr_slots[slot] == LLADDR_SLOT_EMPTY) {
+      break;
+    }
+    home = lladdr_hash(&key_from_index(lladdr_slots[slot] - 1)->lladdr);
+    /* Move the entry into the hole unless its home slot lies
+     * (cyclically) in ]hole, slot] */
+    if(((slot - home) & (NBR_TABLE_LLADDR_HASH_SIZE - 1))
+       >= ((slot - hole) & (NBR_TABLE_LLADDR_HASH_SIZE - 1))) {
+      lladdr_slots[hole] = lladdr_slots[slot];
+      hole = slot;
+    }
+  }
+  lladdr_slots[hole] = LLADDR_SLOT_EMPTY;
+}
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
 /*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_WITH_LLADDR_HASH
+  lladdr_slot_t index;
+#else /* NBR_TABLE_WITH_LLADDR_HASH */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_LLADDR_HASH
+  index = lladdr_slots[lladdr_slot_find(lladdr)];
+  return (int)index - 1;
+#else /* NBR_TABLE_WITH_LLADDR_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -144,6 +233,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -195,6 +285,9 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_WITH_LLADDR_HASH
+  lladdr_slot_remove(least_used_key);
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -377,6 +470,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_LLADDR_HASH
+    lladdr_slot_add(key);
+#endif /* NBR_TABLE_WITH_LLADDR_HASH */
   }
 
   /* Get item in the current table */
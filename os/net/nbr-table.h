@@ -46,6 +46,33 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Index neighbors by link-layer address in an open-addressing hash table,
+ * making nbr_table_get_from_lladdr() constant-time instead of a scan
+ * of all neighbors. Useful with large neighbor tables. */
+#ifdef NBR_TABLE_CONF_WITH_LLADDR_HASH
+#define NBR_TABLE_WITH_LLADDR_HASH NBR_TABLE_CONF_WITH_LLADDR_HASH
+#else /* NBR_TABLE_CONF_WITH_LLADDR_HASH */
+#define NBR_TABLE_WITH_LLADDR_HASH 0
+#endif /* NBR_TABLE_CONF_WITH_LLADDR_HASH */
+
+/* Number of slots of the link-layer address hash table. Must be a power
+ * of two, larger than NBR_TABLE_MAX_NEIGHBORS. */
+#ifdef NBR_TABLE_CONF_LLADDR_HASH_SIZE
+#define NBR_TABLE_LLADDR_HASH_SIZE NBR_TABLE_CONF_LLADDR_HASH_SIZE
+#elif NBR_TABLE_MAX_NEIGHBORS <= 8
+#define NBR_TABLE_LLADDR_HASH_SIZE 16
+#elif NBR_TABLE_MAX_NEIGHBORS <= 16
+#define NBR_TABLE_LLADDR_HASH_SIZE 32
+#elif NBR_TABLE_MAX_NEIGHBORS <= 32
+#define NBR_TABLE_LLADDR_HASH_SIZE 64
+#elif NBR_TABLE_MAX_NEIGHBORS <= 64
+#define NBR_TABLE_LLADDR_HASH_SIZE 128
+#elif NBR_TABLE_MAX_NEIGHBORS <= 128
+#define NBR_TABLE_LLADDR_HASH_SIZE 256
+#else
+#define NBR_TABLE_LLADDR_HASH_SIZE 512
+#endif /* NBR_TABLE_CONF_LLADDR_HASH_SIZE */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
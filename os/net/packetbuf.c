@@ -74,6 +74,7 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 void
 packetbuf_clear(void)
 {
+  packetbuf = (uint8_t *)packetbuf_aligned;
   buflen = bufptr = 0;
   hdrlen = 0;
 
@@ -133,6 +134,31 @@ packetbuf_hdrreduce(int size)
 }
 /*---------------------------------------------------------------------------*/
 void
+packetbuf_alias(void *buf, uint16_t len)
+{
+  packetbuf = buf;
+  buflen = MIN(PACKETBUF_SIZE, len);
+  bufptr = 0;
+  hdrlen = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_unalias(void)
+{
+  if(packetbuf_is_alias()) {
+    packetbuf = (uint8_t *)packetbuf_aligned;
+    buflen = bufptr = 0;
+    hdrlen = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+packetbuf_is_alias(void)
+{
+  return packetbuf != (uint8_t *)packetbuf_aligned;
+}
+/*---------------------------------------------------------------------------*/
+void
 packetbuf_set_datalen(uint16_t len)
 {
   PRINTF("packetbuf_set_len: len %d\n", len);
@@ -191,6 +191,40 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Make the packetbuf refer to an external buffer
+ * \param buf  The buffer, at least PACKETBUF_SIZE bytes long
+ * \param len  The length of the data in the buffer
+ *
+ *             This function makes the packetbuf use buf, which
+ *             holds len bytes of data, in place of its own buffer,
+ *             so that the data can be accessed without being copied.
+ *             The attributes are left unchanged. Modifying the
+ *             packetbuf modifies buf.
+ *
+ *             The packetbuf returns to its own, empty, buffer on
+ *             packetbuf_unalias(), packetbuf_clear() or
+ *             packetbuf_copyfrom().
+ *
+ */
+void packetbuf_alias(void *buf, uint16_t len);
+
+/**
+ * \brief      Make the packetbuf use its own buffer again
+ *
+ *             If the packetbuf refers to an external buffer, it
+ *             returns to its own buffer, empty. The attributes are
+ *             left unchanged.
+ *
+ */
+void packetbuf_unalias(void);
+
+/**
+ * \brief      Check if the packetbuf refers to an external buffer
+ * \retval     Non-zero if packetbuf_alias() is in effect
+ */
+int packetbuf_is_alias(void);
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
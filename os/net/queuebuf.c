@@ -60,6 +60,9 @@ struct queuebuf {
   int line;
   clock_time_t time;
 #endif /* QUEUEBUF_DEBUG */
+#if QUEUEBUF_ZERO_COPY
+  uint8_t refs;
+#endif /* QUEUEBUF_ZERO_COPY */
 #if WITH_SWAP
   enum {IN_RAM, IN_CFS} location;
   union {
@@ -112,6 +115,11 @@ static struct ctimer renew_timer;
 
 #endif
 
+#if QUEUEBUF_ZERO_COPY
+/* The queuebuf aliased by the packetbuf */
+static struct queuebuf *aliased;
+#endif /* QUEUEBUF_ZERO_COPY */
+
 #if QUEUEBUF_DEBUG
 #include "lib/list.h"
 LIST(queuebuf_list);
@@ -342,6 +350,9 @@ queuebuf_new_from_packetbuf(void)
 
     buframptr->len = packetbuf_copyto(buframptr->data);
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if QUEUEBUF_ZERO_COPY
+    buf->refs = 1;
+#endif /* QUEUEBUF_ZERO_COPY */
 
 #if WITH_SWAP
     if(buf->location == IN_CFS) {
@@ -396,6 +407,11 @@ void
 queuebuf_free(struct queuebuf *buf)
 {
   if(memb_inmemb(&bufmem, buf)) {
+#if QUEUEBUF_ZERO_COPY
+    if(--buf->refs > 0) {
+      return;
+    }
+#endif /* QUEUEBUF_ZERO_COPY */
 #if WITH_SWAP
     if(buf->location == IN_RAM) {
       memb_free(&buframmem, buf->ram_ptr);
@@ -426,6 +442,41 @@ queuebuf_to_packetbuf(struct queuebuf *b)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_ZERO_COPY
+struct queuebuf *
+queuebuf_ref(struct queuebuf *b)
+{
+  if(memb_inmemb(&bufmem, b)) {
+    b->refs++;
+  }
+  return b;
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_alias_to_packetbuf(struct queuebuf *b)
+{
+  queuebuf_release_alias();
+  if(memb_inmemb(&bufmem, b)) {
+    aliased = queuebuf_ref(b);
+    packetbuf_alias(b->ram_ptr->data, b->ram_ptr->len);
+    packetbuf_attr_copyfrom(b->ram_ptr->attrs, b->ram_ptr->addrs);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_release_alias(void)
+{
+  if(aliased != NULL) {
+    /* The packetbuf may already have been cleared and reused */
+    if(packetbuf_is_alias() && packetbuf_hdrptr() == aliased->ram_ptr->data) {
+      packetbuf_unalias();
+    }
+    queuebuf_free(aliased);
+    aliased = NULL;
+  }
+}
+#endif /* QUEUEBUF_ZERO_COPY */
+/*---------------------------------------------------------------------------*/
 void *
 queuebuf_dataptr(struct queuebuf *b)
 {
@@ -79,6 +79,20 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+/* QUEUEBUF_ZERO_COPY enables reference counting of queuebufs and lets
+   the packetbuf alias a queuebuf, so that a MAC layer can transmit a
+   queued frame, and retransmit it, without copying it back to the
+   packetbuf. The queuebufs must all be in RAM. */
+#ifdef QUEUEBUF_CONF_ZERO_COPY
+#define QUEUEBUF_ZERO_COPY QUEUEBUF_CONF_ZERO_COPY
+#else /* QUEUEBUF_CONF_ZERO_COPY */
+#define QUEUEBUF_ZERO_COPY 0
+#endif /* QUEUEBUF_CONF_ZERO_COPY */
+
+#if QUEUEBUF_ZERO_COPY && WITH_SWAP
+#error "QUEUEBUF_CONF_ZERO_COPY requires all queuebufs in RAM (QUEUEBUFRAM_CONF_NUM >= QUEUEBUF_CONF_NUM)"
+#endif
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -101,6 +115,19 @@ void queuebuf_update_from_packetbuf(struct queuebuf *b);
 void queuebuf_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
+#if QUEUEBUF_ZERO_COPY
+/* Takes a reference to a queuebuf. queuebuf_free() drops a reference,
+   the queuebuf is freed when the last one is dropped. */
+struct queuebuf *queuebuf_ref(struct queuebuf *b);
+
+/* Makes the packetbuf alias the data of a queuebuf, in place of
+   queuebuf_to_packetbuf(). The attributes are copied to the packetbuf.
+   The alias holds a reference to the queuebuf until
+   queuebuf_release_alias() is called. */
+void queuebuf_alias_to_packetbuf(struct queuebuf *b);
+void queuebuf_release_alias(void);
+#endif /* QUEUEBUF_ZERO_COPY */
+
 void *queuebuf_dataptr(struct queuebuf *b);
 int queuebuf_datalen(struct queuebuf *b);
 
@@ -98,6 +98,20 @@
 #define RPL_SUPPORTED_OFS {&rpl_mrhof}
 #endif /* RPL_CONF_SUPPORTED_OFS */
 
+/*
+ * The number of candidate parents kept sorted by path cost. When
+ * non-zero, the path cost, rank and acceptability computed by the OF
+ * are cached in each neighbor, and recomputed only when the neighbor
+ * advertises a new rank or its link statistics are updated. Parent
+ * selection then only compares the candidates instead of the whole
+ * neighbor table. 0 compares all neighbors at every selection.
+ */
+#ifdef RPL_CONF_PARENT_CANDIDATES
+#define RPL_PARENT_CANDIDATES RPL_CONF_PARENT_CANDIDATES
+#else /* RPL_CONF_PARENT_CANDIDATES */
+#define RPL_PARENT_CANDIDATES 0
+#endif /* RPL_CONF_PARENT_CANDIDATES */
+
 /*
  * Enable/disable RPL Metric Containers (MC). The actual MC in use
  * for a given DODAG is decided at runtime, when joining. Note that
@@ -132,6 +132,10 @@ void
 rpl_dag_periodic(unsigned seconds)
 {
   if(curr_instance.used) {
+    /* Link statistics may also change without a link callback, e.g. on
+    TSCH keepalives. Recompute the cached OF state once in a while. */
+    rpl_neighbor_invalidate_all();
+
     if(curr_instance.dag.lifetime != RPL_LIFETIME(RPL_INFINITE_LIFETIME)) {
       curr_instance.dag.lifetime =
         curr_instance.dag.lifetime > seconds ? curr_instance.dag.lifetime - seconds : 0;
@@ -377,6 +381,13 @@ update_nbr_from_dio(uip_ipaddr_t *from, rpl_dio_t *dio)
   }
 
   /* Update neighbor info from DIO */
+  if(nbr->rank != dio->rank
+#if RPL_WITH_MC
+     || memcmp(&nbr->mc, &dio->mc, sizeof(nbr->mc)) != 0
+#endif /* RPL_WITH_MC */
+     ) {
+    rpl_neighbor_invalidate(nbr);
+  }
   nbr->rank = dio->rank;
   nbr->dtsn = dio->dtsn;
 #if RPL_WITH_MC
@@ -679,6 +690,7 @@ rpl_process_hbh(rpl_nbr_t *sender, uint16_t sender_rank, int loop_detected, int
      * the sender's rank from ext header */
     if(sender != NULL) {
       sender->rank = sender_rank;
+      rpl_neighbor_invalidate(sender);
       /* Select DAG and preferred parent. In case of a parent switch,
       the new parent will be used to forward the current packet. */
       rpl_dag_update_state();
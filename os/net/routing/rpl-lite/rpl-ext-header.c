@@ -232,6 +232,7 @@ insert_srh_header(void)
   uip_sr_node_t *dest_node;
   uip_sr_node_t *root_node;
   uip_sr_node_t *node;
+  const uip_sr_path_t *path = NULL;
   uip_ipaddr_t node_addr;
 
   LOG_INFO("SRH creating source routing header with destination ");
@@ -261,35 +262,46 @@ insert_srh_header(void)
     return 0;
   }
 
-  if(!uip_sr_is_addr_reachable(NULL, &UIP_IP_BUF->destipaddr)) {
-    LOG_ERR("SRH no path found to destination\n");
-    return 0;
-  }
+#if UIP_SR_PATH_CACHE_SIZE
+  path = uip_sr_path_cache_lookup(dest_node, &UIP_IP_BUF->destipaddr);
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+
+  if(path != NULL) {
+    /* The graph did not change since the route was cached */
+    path_len = path->path_len;
+    cmpri = path->cmpr;
+    cmpre = cmpri;
+  } else {
+    if(!uip_sr_is_addr_reachable(NULL, &UIP_IP_BUF->destipaddr)) {
+      LOG_ERR("SRH no path found to destination\n");
+      return 0;
+    }
 
-  /* Compute path length and compression factors (we use cmpri == cmpre) */
-  path_len = 0;
-  node = dest_node->parent;
-  /* For simplicity, we use cmpri = cmpre */
-  cmpri = 15;
-  cmpre = 15;
+    /* Compute path length and compression factors (we use cmpri == cmpre) */
+    path_len = 0;
+    node = dest_node->parent;
+    /* For simplicity, we use cmpri = cmpre */
+    cmpri = 15;
+    cmpre = 15;
 
-  /* Note that in case of a direct child (node == root_node), we insert
-  SRH anyway, as RFC 6553 mandates that routed datagrams must include
-  SRH or the RPL option (or both) */
+    /* Note that in case of a direct child (node == root_node), we insert
+    SRH anyway, as RFC 6553 mandates that routed datagrams must include
+    SRH or the RPL option (or both) */
 
-  while(node != NULL && node != root_node) {
+    while(node != NULL && node != root_node) {
 
-    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+      NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
 
-    /* How many bytes in common between all nodes in the path? */
-    cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
-    cmpre = cmpri;
+      /* How many bytes in common between all nodes in the path? */
+      cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
+      cmpre = cmpri;
 
-    LOG_INFO("SRH Hop ");
-    LOG_INFO_6ADDR(&node_addr);
-    LOG_INFO_("\n");
-    node = node->parent;
-    path_len++;
+      LOG_INFO("SRH Hop ");
+      LOG_INFO_6ADDR(&node_addr);
+      LOG_INFO_("\n");
+      node = node->parent;
+      path_len++;
+    }
   }
 
   /* Extension header length: fixed headers + (n-1) * (16-ComprI) + (16-ComprE)*/
@@ -332,18 +344,41 @@ insert_srh_header(void)
   node = dest_node;
   hop_ptr = ((uint8_t *)UIP_RH_BUF) + ext_len - padding; /* Pointer where to write the next hop compressed address */
 
-  while(node != NULL && node->parent != root_node) {
-    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+  if(path != NULL) {
+    memcpy(hop_ptr - path_len * (16 - cmpri), path->addr, path_len * (16 - cmpri));
+    uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &path->next_hop);
+  } else {
+#if UIP_SR_PATH_CACHE_SIZE
+    uip_sr_path_t *entry = NULL;
+#endif /* UIP_SR_PATH_CACHE_SIZE */
 
-    hop_ptr -= (16 - cmpri);
-    memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
+    while(node != NULL && node->parent != root_node) {
+      NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
 
-    node = node->parent;
-  }
+      hop_ptr -= (16 - cmpri);
+      memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
+
+      node = node->parent;
+    }
 
-  /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
-  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
-  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
+#if UIP_SR_PATH_CACHE_SIZE
+    if(path_len * (16 - cmpri) <= UIP_SR_PATH_CACHE_ADDR_LEN) {
+      entry = uip_sr_path_cache_add(dest_node, &UIP_IP_BUF->destipaddr);
+      entry->path_len = path_len;
+      entry->cmpr = cmpri;
+      memcpy(entry->addr, hop_ptr, path_len * (16 - cmpri));
+    }
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+
+    /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+    uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
+#if UIP_SR_PATH_CACHE_SIZE
+    if(entry != NULL) {
+      uip_ipaddr_copy(&entry->next_hop, &node_addr);
+    }
+#endif /* UIP_SR_PATH_CACHE_SIZE */
+  }
 
   /* In-place update of IPv6 length field */
   temp_len = UIP_IP_BUF->len[1];
@@ -58,12 +58,90 @@
 void RPL_CALLBACK_PARENT_SWITCH(rpl_nbr_t *old, rpl_nbr_t *new);
 #endif /* RPL_CALLBACK_PARENT_SWITCH */
 
+/* A configurable function called after every parent selection, with the
+number of neighbors compared and the number of neighbors for which the OF
+state was computed */
+#ifdef RPL_CALLBACK_PARENT_EVALUATION
+void RPL_CALLBACK_PARENT_EVALUATION(unsigned compared, unsigned computed);
+static unsigned eval_compared;
+static unsigned eval_computed;
+#define EVAL_COUNT(counter) (counter)++
+#else /* RPL_CALLBACK_PARENT_EVALUATION */
+#define EVAL_COUNT(counter)
+#endif /* RPL_CALLBACK_PARENT_EVALUATION */
+
 static rpl_nbr_t * best_parent(int fresh_only);
 
 /*---------------------------------------------------------------------------*/
 /* Per-neighbor RPL information */
 NBR_TABLE_GLOBAL(rpl_nbr_t, rpl_neighbors);
 
+#if RPL_PARENT_CANDIDATES
+/* Flags of the OF state cached in each neighbor */
+#define NBR_CACHE_VALID      0x01
+#define NBR_CACHE_ACCEPTABLE 0x02
+
+/* The neighbors acceptable to the OF with the lowest path cost, sorted
+by increasing path cost */
+static rpl_nbr_t *candidates[RPL_PARENT_CANDIDATES];
+static uint8_t candidate_count;
+/* Set if some acceptable neighbors did not fit in the candidates */
+static uint8_t candidates_truncated;
+/* Set when the candidates must be sorted again */
+static uint8_t candidates_dirty;
+
+/*---------------------------------------------------------------------------*/
+static void
+update_cache(rpl_nbr_t *nbr)
+{
+  if(nbr->cache_flags == 0) {
+    EVAL_COUNT(eval_computed);
+    nbr->path_cost = curr_instance.of->nbr_path_cost(nbr);
+    nbr->rank_via_nbr = curr_instance.of->rank_via_nbr(nbr);
+    nbr->cache_flags = NBR_CACHE_VALID;
+    if(curr_instance.of->nbr_is_acceptable_parent(nbr)) {
+      nbr->cache_flags |= NBR_CACHE_ACCEPTABLE;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_candidates(void)
+{
+  rpl_nbr_t *nbr;
+  int i;
+
+  candidate_count = 0;
+  candidates_truncated = 0;
+
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    update_cache(nbr);
+    if(!(nbr->cache_flags & NBR_CACHE_ACCEPTABLE)) {
+      continue;
+    }
+
+    /* Insert the neighbor in order, dropping the last candidate if the
+    set is full */
+    i = candidate_count;
+    if(i == RPL_PARENT_CANDIDATES) {
+      candidates_truncated = 1;
+      if(nbr->path_cost >= candidates[i - 1]->path_cost) {
+        continue;
+      }
+      i--;
+    } else {
+      candidate_count++;
+    }
+    for(; i > 0 && candidates[i - 1]->path_cost > nbr->path_cost; i--) {
+      candidates[i] = candidates[i - 1];
+    }
+    candidates[i] = nbr;
+  }
+
+  candidates_dirty = 0;
+}
+#endif /* RPL_PARENT_CANDIDATES */
+
 /*---------------------------------------------------------------------------*/
 static int
 max_acceptable_rank(void)
@@ -193,6 +271,10 @@ rpl_get_ds6_nbr(rpl_nbr_t *nbr)
 static void
 remove_neighbor(rpl_nbr_t *nbr)
 {
+#if RPL_PARENT_CANDIDATES
+  /* The neighbor may be one of the candidates */
+  candidates_dirty = 1;
+#endif /* RPL_PARENT_CANDIDATES */
   /* Make sure we don't point to a removed neighbor. Note that we do not need
   to worry about preferred_parent here, as it is locked in the the table
   and will never be removed by external modules. */
@@ -234,7 +316,12 @@ rpl_rank_t
 rpl_neighbor_rank_via_nbr(rpl_nbr_t *nbr)
 {
   if(nbr != NULL && curr_instance.of->rank_via_nbr != NULL) {
+#if RPL_PARENT_CANDIDATES
+    update_cache(nbr);
+    return nbr->rank_via_nbr;
+#else /* RPL_PARENT_CANDIDATES */
     return curr_instance.of->rank_via_nbr(nbr);
+#endif /* RPL_PARENT_CANDIDATES */
   }
   return RPL_INFINITE_RANK;
 }
@@ -317,6 +404,30 @@ rpl_neighbor_set_preferred_parent(rpl_nbr_t *nbr)
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_invalidate(rpl_nbr_t *nbr)
+{
+#if RPL_PARENT_CANDIDATES
+  if(nbr != NULL) {
+    nbr->cache_flags = 0;
+    candidates_dirty = 1;
+  }
+#endif /* RPL_PARENT_CANDIDATES */
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_invalidate_all(void)
+{
+#if RPL_PARENT_CANDIDATES
+  rpl_nbr_t *nbr;
+
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    nbr->cache_flags = 0;
+  }
+  candidates_dirty = 1;
+#endif /* RPL_PARENT_CANDIDATES */
+}
+/*---------------------------------------------------------------------------*/
 /* Remove DAG neighbors with a rank that is at least the same as minimum_rank. */
 void
 rpl_neighbor_remove_all(void)
@@ -344,6 +455,46 @@ rpl_neighbor_get_from_ipaddr(uip_ipaddr_t *addr)
   return nbr_table_get_from_lladdr(rpl_neighbors, (linkaddr_t *)lladdr);
 }
 /*---------------------------------------------------------------------------*/
+static int
+is_candidate(rpl_nbr_t *nbr, int fresh_only)
+{
+  EVAL_COUNT(eval_compared);
+
+  if(!acceptable_rank(nbr->rank)) {
+    /* Exclude neighbors with a rank that is not acceptable) */
+    return 0;
+  }
+
+#if RPL_PARENT_CANDIDATES
+  update_cache(nbr);
+  if(!(nbr->cache_flags & NBR_CACHE_ACCEPTABLE)) {
+    return 0;
+  }
+#else /* RPL_PARENT_CANDIDATES */
+  EVAL_COUNT(eval_computed);
+  if(!curr_instance.of->nbr_is_acceptable_parent(nbr)) {
+    return 0;
+  }
+#endif /* RPL_PARENT_CANDIDATES */
+
+  if(fresh_only && !rpl_neighbor_is_fresh(nbr)) {
+    /* Filter out non-fresh nerighbors if fresh_only is set */
+    return 0;
+  }
+
+#if UIP_ND6_SEND_NS
+  {
+  uip_ds6_nbr_t *ds6_nbr = rpl_get_ds6_nbr(nbr);
+  /* Exclude links to a neighbor that is not reachable at a NUD level */
+  if(ds6_nbr == NULL || ds6_nbr->state != NBR_REACHABLE) {
+    return 0;
+  }
+  }
+#endif /* UIP_ND6_SEND_NS */
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 static rpl_nbr_t *
 best_parent(int fresh_only)
 {
@@ -354,38 +505,49 @@ best_parent(int fresh_only)
     return NULL;
   }
 
-  /* Search for the best parent according to the OF */
-  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
+#if RPL_PARENT_CANDIDATES
+  {
+  int i;
 
-    if(!acceptable_rank(nbr->rank) || !curr_instance.of->nbr_is_acceptable_parent(nbr)) {
-      /* Exclude neighbors with a rank that is not acceptable) */
-      continue;
-    }
+  if(candidates_dirty) {
+    update_candidates();
+  }
 
-    if(fresh_only && !rpl_neighbor_is_fresh(nbr)) {
-      /* Filter out non-fresh nerighbors if fresh_only is set */
-      continue;
-    }
+  /* Start from the preferred parent, which the OF may keep within its
+  hysteresis even if it is not among the candidates */
+  nbr = curr_instance.dag.preferred_parent;
+  if(nbr != NULL && is_candidate(nbr, fresh_only)) {
+    best = nbr;
+  }
 
-#if UIP_ND6_SEND_NS
-    {
-    uip_ds6_nbr_t *ds6_nbr = rpl_get_ds6_nbr(nbr);
-    /* Exclude links to a neighbor that is not reachable at a NUD level */
-    if(ds6_nbr == NULL || ds6_nbr->state != NBR_REACHABLE) {
-      continue;
+  for(i = 0; i < candidate_count; i++) {
+    nbr = candidates[i];
+    if(nbr != curr_instance.dag.preferred_parent && is_candidate(nbr, fresh_only)) {
+      best = curr_instance.of->best_parent(best, nbr);
     }
-    }
-#endif /* UIP_ND6_SEND_NS */
+  }
 
-    /* Now we have an acceptable parent, check if it is the new best */
-    best = curr_instance.of->best_parent(best, nbr);
+  /* The neighbors left out of the candidates have a higher path cost, and
+  only need to be compared when no candidate is usable */
+  if(best != NULL || !candidates_truncated) {
+    return best;
+  }
+  }
+#endif /* RPL_PARENT_CANDIDATES */
+
+  /* Search for the best parent according to the OF */
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    if(is_candidate(nbr, fresh_only)) {
+      /* Now we have an acceptable parent, check if it is the new best */
+      best = curr_instance.of->best_parent(best, nbr);
+    }
   }
 
   return best;
 }
 /*---------------------------------------------------------------------------*/
-rpl_nbr_t *
-rpl_neighbor_select_best(void)
+static rpl_nbr_t *
+select_best(void)
 {
   rpl_nbr_t *best;
 
@@ -448,6 +610,22 @@ rpl_neighbor_select_best(void)
 #endif /* RPL_WITH_PROBING */
 }
 /*---------------------------------------------------------------------------*/
+rpl_nbr_t *
+rpl_neighbor_select_best(void)
+{
+#ifdef RPL_CALLBACK_PARENT_EVALUATION
+  rpl_nbr_t *best;
+
+  eval_compared = 0;
+  eval_computed = 0;
+  best = select_best();
+  RPL_CALLBACK_PARENT_EVALUATION(eval_compared, eval_computed);
+  return best;
+#else /* RPL_CALLBACK_PARENT_EVALUATION */
+  return select_best();
+#endif /* RPL_CALLBACK_PARENT_EVALUATION */
+}
+/*---------------------------------------------------------------------------*/
 void
 rpl_neighbor_init(void)
 {
@@ -185,6 +185,20 @@ void rpl_neighbor_print_list(const char *str);
 */
 void rpl_neighbor_remove_all(void);
 
+/**
+ * Tells that the rank, metric container or link statistics of a
+ * neighbor changed, so that its OF state is recomputed at the next
+ * parent selection. Only needed with RPL_PARENT_CANDIDATES.
+ *
+ * \param nbr The neighbor
+*/
+void rpl_neighbor_invalidate(rpl_nbr_t *nbr);
+
+/**
+ * Recompute the OF state of all neighbors at the next parent selection
+*/
+void rpl_neighbor_invalidate_all(void);
+
 /**
  * Returns the best candidate for preferred parent
  *
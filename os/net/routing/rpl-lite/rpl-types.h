@@ -142,6 +142,13 @@ struct rpl_nbr {
 #endif /* RPL_WITH_MC */
   rpl_rank_t rank;
   uint8_t dtsn;
+#if RPL_PARENT_CANDIDATES
+  /* OF state cached for parent selection, valid while
+  cache_flags is non-zero */
+  uint16_t path_cost;
+  rpl_rank_t rank_via_nbr;
+  uint8_t cache_flags;
+#endif /* RPL_PARENT_CANDIDATES */
 };
 typedef struct rpl_nbr rpl_nbr_t;
 
@@ -106,6 +106,7 @@ rpl_link_callback(const linkaddr_t *addr, int status, int numtx)
       }
       /* Link stats were updated, and we need to update our internal state.
       Updating from here is unsafe; postpone */
+      rpl_neighbor_invalidate(nbr);
       LOG_INFO("packet sent to ");
       LOG_INFO_LLADDR(addr);
       LOG_INFO_(", status %u, tx %u, new link metric %u\n", status, numtx, rpl_neighbor_get_link_metric(nbr));
@@ -55,5 +55,6 @@ void tun_init(void);
 int slip_init(void);
 int slip_set_fd(int maxfd, fd_set *rset, fd_set *wset);
 void slip_handle_fd(fd_set *rset, fd_set *wset);
+int slip_has_room(void);
 
 #endif /* BORDER_ROUTER_H_ */
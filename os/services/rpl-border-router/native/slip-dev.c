@@ -53,6 +53,7 @@
 
 #include "net/netstack.h"
 #include "net/packetbuf.h"
+#include "net/queuebuf.h"
 #include "cmd.h"
 #include "border-router-cmds.h"
 
@@ -70,6 +71,24 @@ extern speed_t slip_config_b_rate;
 #define SEND_DELAY 0
 #endif
 
+/*
+ * Scan for END/ESC with memchr() and copy the runs of plain bytes in
+ * between as a whole, instead of going through the SLIP stream one byte
+ * at a time. All queued output is written with a single write().
+ */
+#ifdef SLIP_DEV_CONF_BULK
+#define SLIP_DEV_BULK SLIP_DEV_CONF_BULK
+#else
+#define SLIP_DEV_BULK 1
+#endif
+
+#if SLIP_DEV_BULK
+#define SLIP_BUF_SIZE 16384
+#define SLIP_READ_SIZE 4096
+#else
+#define SLIP_BUF_SIZE 2048
+#endif
+
 int devopen(const char *dev, int flags);
 
 static FILE *inslip;
@@ -168,6 +187,180 @@ slip_packet_input(unsigned char *data, int len)
   NETSTACK_MAC.input();
 }
 /*---------------------------------------------------------------------------*/
+static unsigned char inbuf[2048];
+static int inbufptr = 0;
+/*---------------------------------------------------------------------------*/
+/* Handles a complete SLIP frame received from the radio */
+static void
+slip_frame_input(unsigned char *buf, int len)
+{
+  int i;
+
+  if(buf[0] == '!') {
+    command_context = CMD_CONTEXT_RADIO;
+    cmd_input(buf, len);
+  } else if(buf[0] == '?') {
+#define DEBUG_LINE_MARKER '\r'
+  } else if(buf[0] == DEBUG_LINE_MARKER) {
+    fwrite(buf + 1, len - 1, 1, stdout);
+  } else if(is_sensible_string(buf, len)) {
+    if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
+      fwrite(buf, len, 1, stdout);
+    }
+  } else {
+    if(slip_config_verbose > 2) {
+      printf("Packet from SLIP of length %d - write TUN\n", len);
+      if(slip_config_verbose > 4) {
+#if WIRESHARK_IMPORT_FORMAT
+        printf("0000");
+        for(i = 0; i < len; i++) {
+          printf(" %02x", buf[i]);
+        }
+#else
+        printf("         ");
+        for(i = 0; i < len; i++) {
+          printf("%02x", buf[i]);
+          if((i & 3) == 3) {
+            printf(" ");
+          }
+          if((i & 15) == 15) {
+            printf("\n         ");
+          }
+        }
+#endif
+        printf("\n");
+      }
+    }
+    slip_packet_input(buf, len);
+  }
+}
+#if SLIP_DEV_BULK
+/*---------------------------------------------------------------------------*/
+/* Where the next END and ESC are in a buffer that is being scanned */
+struct slip_scan {
+  const uint8_t *end;
+  const uint8_t *next_end;
+  const uint8_t *next_esc;
+};
+/*---------------------------------------------------------------------------*/
+static const uint8_t *
+find_byte(const uint8_t *p, uint8_t c, const uint8_t *end)
+{
+  const uint8_t *q = memchr(p, c, end - p);
+  return q != NULL ? q : end;
+}
+/*---------------------------------------------------------------------------*/
+static void
+slip_scan_init(struct slip_scan *scan, const uint8_t *p, const uint8_t *end)
+{
+  scan->end = end;
+  scan->next_end = find_byte(p, SLIP_END, end);
+  scan->next_esc = find_byte(p, SLIP_ESC, end);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Returns the first END or ESC at or after p, or the end of the buffer.
+ * Each memchr() result is kept until p has moved past it, so every byte
+ * is scanned at most once per character.
+ */
+static const uint8_t *
+slip_scan_next(struct slip_scan *scan, const uint8_t *p)
+{
+  if(scan->next_end < p) {
+    scan->next_end = find_byte(p, SLIP_END, scan->end);
+  }
+  if(scan->next_esc < p) {
+    scan->next_esc = find_byte(p, SLIP_ESC, scan->end);
+  }
+  return scan->next_end < scan->next_esc ? scan->next_end : scan->next_esc;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t dropping;
+/*---------------------------------------------------------------------------*/
+static void
+slip_input_append(const uint8_t *data, int len)
+{
+  if(dropping || len == 0) {
+    return;
+  }
+  if(inbufptr + len > sizeof(inbuf)) {
+    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr + len);
+    /* Skip the rest of the packet, up to the next END */
+    inbufptr = 0;
+    dropping = 1;
+    return;
+  }
+  memcpy(inbuf + inbufptr, data, len);
+  inbufptr += len;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Read from serial in large chunks and unescape them run by run. An ESC at
+ * the end of a chunk is remembered until the next one arrives.
+ */
+static void
+serial_input_bulk(int fd)
+{
+  static uint8_t rxbuf[SLIP_READ_SIZE];
+  static uint8_t escaped;
+  struct slip_scan scan;
+  const uint8_t *p, *q, *end;
+  ssize_t n;
+  uint8_t c;
+
+  do {
+    n = read(fd, rxbuf, sizeof(rxbuf));
+    if(n == -1 && (errno == EAGAIN || errno == EINTR)) {
+      return;
+    }
+    if(n == -1) {
+      err(1, "serial_input: read");
+    }
+    if(n == 0) {
+#ifdef linux
+      /* The device or the connection is gone */
+      err(1, "serial_input: read");
+#endif
+      return;
+    }
+    slip_received += n;
+
+    p = rxbuf;
+    end = rxbuf + n;
+    slip_scan_init(&scan, p, end);
+    while(p < end) {
+      if(escaped) {
+        escaped = 0;
+        c = *p++;
+        if(c == SLIP_ESC_END) {
+          c = SLIP_END;
+        } else if(c == SLIP_ESC_ESC) {
+          c = SLIP_ESC;
+        }
+        slip_input_append(&c, 1);
+        continue;
+      }
+
+      q = slip_scan_next(&scan, p);
+      slip_input_append(p, q - p);
+      if(q == end) {
+        break;
+      }
+      if(*q == SLIP_END) {
+        if(inbufptr > 0) {
+          slip_frame_input(inbuf, inbufptr);
+          inbufptr = 0;
+        }
+        dropping = 0;
+      } else {
+        escaped = 1;
+      }
+      p = q + 1;
+    }
+  } while(n == sizeof(rxbuf));
+}
+#endif /* SLIP_DEV_BULK */
+/*---------------------------------------------------------------------------*/
 /*
  * Read from serial, when we have a packet call slip_packet_input. No output
  * buffering, input buffered by stdio.
@@ -175,11 +368,17 @@ slip_packet_input(unsigned char *data, int len)
 void
 serial_input(FILE *inslip)
 {
-  static unsigned char inbuf[2048];
-  static int inbufptr = 0;
-  int ret, i;
+  int ret;
   unsigned char c;
 
+#if SLIP_DEV_BULK
+  /* The line echo of the higher verbose levels works byte by byte */
+  if(slip_config_verbose < 2) {
+    serial_input_bulk(fileno(inslip));
+    return;
+  }
+#endif /* SLIP_DEV_BULK */
+
 #ifdef linux
   ret = fread(&c, 1, 1, inslip);
   if(ret == -1 || ret == 0) {
@@ -208,43 +407,7 @@ after_fread:
   switch(c) {
   case SLIP_END:
     if(inbufptr > 0) {
-      if(inbuf[0] == '!') {
-        command_context = CMD_CONTEXT_RADIO;
-        cmd_input(inbuf, inbufptr);
-      } else if(inbuf[0] == '?') {
-#define DEBUG_LINE_MARKER '\r'
-      } else if(inbuf[0] == DEBUG_LINE_MARKER) {
-        fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(inbuf, inbufptr)) {
-        if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
-          fwrite(inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(slip_config_verbose > 2) {
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if(slip_config_verbose > 4) {
-#if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-            for(i = 0; i < inbufptr; i++) {
-              printf(" %02x", inbuf[i]);
-            }
-#else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", inbuf[i]);
-              if((i & 3) == 3) {
-                printf(" ");
-              }
-              if((i & 15) == 15) {
-                printf("\n         ");
-              }
-            }
-#endif
-            printf("\n");
-          }
-        }
-        slip_packet_input(inbuf, inbufptr);
-      }
+      slip_frame_input(inbuf, inbufptr);
       inbufptr = 0;
     }
     break;
@@ -286,7 +449,7 @@ after_fread:
 
   goto read_more;
 }
-unsigned char slip_buf[2048];
+unsigned char slip_buf[SLIP_BUF_SIZE];
 int slip_end, slip_begin, slip_packet_end, slip_packet_count;
 static struct timer send_delay_timer;
 /* delay between slip packets */
@@ -304,11 +467,45 @@ slip_send(int fd, unsigned char c)
   if(c == SLIP_END) {
     /* Full packet received. */
     slip_packet_count++;
+#if SLIP_DEV_BULK
+    /* Without a delay between packets, all of them go out in one write */
+    if(slip_packet_end == 0 || send_delay == 0) {
+      slip_packet_end = slip_end;
+    }
+#else
     if(slip_packet_end == 0) {
       slip_packet_end = slip_end;
     }
+#endif
+  }
+}
+#if SLIP_DEV_BULK
+/*---------------------------------------------------------------------------*/
+/* Makes room for len more bytes at the end of the output buffer */
+static void
+slip_reserve(int len)
+{
+  if(slip_end + len > sizeof(slip_buf) && slip_begin > 0) {
+    /* Reuse the space of the bytes that have already been written */
+    memmove(slip_buf, slip_buf + slip_begin, slip_end - slip_begin);
+    slip_end -= slip_begin;
+    slip_packet_end -= slip_begin;
+    slip_begin = 0;
   }
+  if(slip_end + len > sizeof(slip_buf)) {
+    err(1, "slip_send overflow");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Queues bytes that need no escaping; the room must be reserved */
+static void
+slip_send_run(const uint8_t *data, int len)
+{
+  memcpy(slip_buf + slip_end, data, len);
+  slip_end += len;
+  slip_sent += len;
 }
+#endif /* SLIP_DEV_BULK */
 /*---------------------------------------------------------------------------*/
 int
 slip_empty()
@@ -316,6 +513,25 @@ slip_empty()
   return slip_packet_end == 0;
 }
 /*---------------------------------------------------------------------------*/
+/* Worst case output of one packet from tun: a frame per queuebuf, each
+   as large as border-router-mac.c makes them, with every byte escaped */
+#define SLIP_PACKET_MAX_OUTPUT \
+  (QUEUEBUF_NUM * (2 * (PACKETBUF_NUM_ATTRS * 3 + PACKETBUF_SIZE + 3) + 1))
+
+int
+slip_has_room(void)
+{
+  int room = sizeof(slip_buf) - slip_end;
+
+#if SLIP_DEV_BULK
+  /* slip_reserve() reuses the bytes that have already been written */
+  room += slip_begin;
+#endif /* SLIP_DEV_BULK */
+  /* A packet is always taken when nothing is pending, even if the worst
+     case would not fit, as the buffer was sized for single packets */
+  return slip_end == slip_begin || room >= SLIP_PACKET_MAX_OUTPUT;
+}
+/*---------------------------------------------------------------------------*/
 void
 slip_flushbuf(int fd)
 {
@@ -333,6 +549,18 @@ slip_flushbuf(int fd)
     PROGRESS("Q");		/* Outqueue is full! */
   } else {
     slip_begin += n;
+#if SLIP_DEV_BULK
+    if(slip_begin == slip_end) {
+      /* Everything written, start over at the beginning of the buffer */
+      slip_begin = slip_end = slip_packet_end = slip_packet_count = 0;
+    } else if(slip_begin == slip_packet_end) {
+      /* Only with a send delay: move on to the next packet */
+      slip_packet_count--;
+      slip_packet_end = find_byte(slip_buf + slip_begin, SLIP_END,
+                                  slip_buf + slip_end) - slip_buf + 1;
+      timer_set(&send_delay_timer, send_delay);
+    }
+#else
     if(slip_begin == slip_packet_end) {
       slip_packet_count--;
       if(slip_end > slip_packet_end) {
@@ -355,6 +583,7 @@ slip_flushbuf(int fd)
         }
       }
     }
+#endif /* SLIP_DEV_BULK */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -363,6 +592,10 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
 {
   const uint8_t *p = inbuf;
   int i;
+#if SLIP_DEV_BULK
+  const uint8_t *q, *end = inbuf + len;
+  struct slip_scan scan;
+#endif /* SLIP_DEV_BULK */
 
   if(slip_config_verbose > 2) {
 #ifdef __CYGWIN__
@@ -397,6 +630,21 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
    */
   /* slip_send(outfd, SLIP_END); */
 
+#if SLIP_DEV_BULK
+  /* Worst case: every byte escaped, plus the END */
+  slip_reserve(2 * len + 1);
+  slip_scan_init(&scan, p, end);
+  while(p < end) {
+    q = slip_scan_next(&scan, p);
+    slip_send_run(p, q - p);
+    if(q == end) {
+      break;
+    }
+    slip_send(outfd, SLIP_ESC);
+    slip_send(outfd, *q == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC);
+    p = q + 1;
+  }
+#else
   for(i = 0; i < len; i++) {
     switch(p[i]) {
     case SLIP_END:
@@ -412,6 +660,7 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
       break;
     }
   }
+#endif /* SLIP_DEV_BULK */
   slip_send(outfd, SLIP_END);
   PROGRESS("t");
 }
@@ -66,6 +66,7 @@
 #include "net/packetbuf.h"
 #include "cmd.h"
 #include "border-router.h"
+#include "tun-batch.h"
 
 extern const char *slip_config_ipaddr;
 extern char slip_config_tundev[32];
@@ -213,6 +214,7 @@ tun_init()
     err(1, "main: open");
   }
 
+  tun_batch_init(tunfd);
   select_set_callback(tunfd, &tun_select_callback);
 
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
@@ -236,16 +238,6 @@ tun_output(uint8_t *data, int len)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
-int
-tun_input(unsigned char *data, int maxlen)
-{
-  int size;
-  if((size = read(tunfd, data, maxlen)) == -1) {
-    err(1, "tun_input: read");
-  }
-  return size;
-}
-/*---------------------------------------------------------------------------*/
 static void
 init(void)
 {
@@ -270,7 +262,10 @@ const struct uip_fallback_interface rpl_interface = {
 static int
 set_fd(fd_set *rset, fd_set *wset)
 {
-  FD_SET(tunfd, rset);
+  /* Leave packets in the tun device until SLIP can take them */
+  if(slip_has_room()) {
+    FD_SET(tunfd, rset);
+  }
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -295,13 +290,12 @@ handle_fd(fd_set *rset, fd_set *wset)
   }
 
   if(delaymsec == 0) {
-    int size;
-
     if(FD_ISSET(tunfd, rset)) {
-      size = tun_input(&uip_buf[UIP_LLH_LEN], sizeof(uip_buf));
-      /* printf("TUN data incoming read:%d\n", size); */
-      uip_len = size;
-      tcpip_input();
+      /* Outgoing packets are paced when a base delay is configured,
+         so only drain the tun device without one, for as long as
+         SLIP has room */
+      tun_batch_input(tunfd, slip_config_basedelay ? 1 : TUN_BATCH_SIZE,
+                      slip_has_room);
 
       if(slip_config_basedelay) {
         struct timeval tv;
@@ -46,6 +46,8 @@
 #include "contiki.h"
 #include "lib/list.h"
 
+#include <stddef.h>
+
 LIST(ctimer_list);
 
 static char initialized;
@@ -72,6 +74,19 @@ PROCESS_THREAD(ctimer_process, ev, data)
 
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+#if ETIMER_HEAP
+    c = (struct ctimer *)((char *)data - offsetof(struct ctimer, etimer));
+    /* Ignore the event if the ctimer has been stopped or set again
+       since its etimer expired. */
+    if(c->armed && etimer_expired(&c->etimer)) {
+      c->armed = 0;
+      PROCESS_CONTEXT_BEGIN(c->p);
+      if(c->f != NULL) {
+        c->f(c->ptr);
+      }
+      PROCESS_CONTEXT_END(c->p);
+    }
+#else /* ETIMER_HEAP */
     for(c = list_head(ctimer_list); c != NULL; c = c->next) {
       if(&c->etimer == data) {
 	list_remove(ctimer_list, c);
@@ -83,10 +98,25 @@ PROCESS_THREAD(ctimer_process, ev, data)
 	break;
       }
     }
+#endif /* ETIMER_HEAP */
   }
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+static void
+add_ctimer(struct ctimer *c)
+{
+#if ETIMER_HEAP
+  c->armed = 1;
+  if(initialized) {
+    /* Once the ctimer process runs, the etimers keep track of all
+       pending ctimers. */
+    return;
+  }
+#endif /* ETIMER_HEAP */
+  list_add(ctimer_list, c);
+}
+/*---------------------------------------------------------------------------*/
 void
 ctimer_init(void)
 {
@@ -118,7 +148,7 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
     c->etimer.timer.interval = t;
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -130,7 +160,7 @@ ctimer_reset(struct ctimer *c)
     PROCESS_CONTEXT_END(&ctimer_process);
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -142,18 +172,30 @@ ctimer_restart(struct ctimer *c)
     PROCESS_CONTEXT_END(&ctimer_process);
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_stop(struct ctimer *c)
 {
   if(initialized) {
+#if ETIMER_HEAP
+    /* An earlier expiry of the etimer may still have its event queued,
+       and the ctimer must not be reached through that event once the
+       caller has released it. */
+    process_post_cancel(&ctimer_process, PROCESS_EVENT_TIMER, &c->etimer);
+#endif /* ETIMER_HEAP */
     etimer_stop(&c->etimer);
   } else {
     c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
   }
+#if ETIMER_HEAP
+  c->armed = 0;
+  if(initialized) {
+    return;
+  }
+#endif /* ETIMER_HEAP */
   list_remove(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
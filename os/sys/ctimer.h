@@ -63,6 +63,11 @@ struct ctimer {
   struct process *p;
   void (*f)(void *);
   void *ptr;
+#if ETIMER_HEAP
+  /* Set while the callback is due, so that the ctimer process needs
+     no list of ctimers once it has started. */
+  uint8_t armed;
+#endif /* ETIMER_HEAP */
 };
 
 /**
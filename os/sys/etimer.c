@@ -49,11 +49,153 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+#if ETIMER_HEAP
+/* The root of the pairing heap holds the timer that expires first. */
+static struct etimer *timerheap;
+
+#define EXPIRATION(t) ((t)->timer.start + (t)->timer.interval)
+/* True if timer a expires before timer b, taking wraps into account. */
+#define EXPIRES_BEFORE(a, b)                                    \
+  ((clock_time_t)(EXPIRATION(a) - EXPIRATION(b)) >              \
+   ((clock_time_t)~(clock_time_t)0 >> 1))
+#else /* ETIMER_HEAP */
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
+#endif /* ETIMER_HEAP */
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP
+/* Link two detached heaps, and return the resulting heap. */
+static struct etimer *
+heap_meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(EXPIRES_BEFORE(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+
+  /* b becomes the first child of a. */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  a->next = NULL;
+  a->prev = NULL;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Meld a list of siblings into a single heap, with the usual two-pass
+   scheme that keeps the amortized cost logarithmic. */
+static struct etimer *
+heap_merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b, *pairs, *heap;
+
+  /* First pass: meld pairs from left to right, stacking the results. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    a = heap_meld(a, b);
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: meld the pairs from right to left. */
+  heap = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    heap = heap_meld(heap, a);
+  }
+  return heap;
+}
+/*---------------------------------------------------------------------------*/
+static int
+heap_contains(struct etimer *t)
+{
+  /* Only timers that have been set can be in the heap, and a stopped
+     or expired timer has its process cleared. */
+  return t->p != PROCESS_NONE && t->in_heap;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  t->next = t->prev = t->child = NULL;
+  t->in_heap = 1;
+  timerheap = heap_meld(timerheap, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  if(t == timerheap) {
+    timerheap = heap_merge_pairs(t->child);
+  } else {
+    /* Unlink t from its parent or its previous sibling. */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    timerheap = heap_meld(timerheap, heap_merge_pairs(t->child));
+  }
+  t->next = t->prev = t->child = NULL;
+  t->in_heap = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Find a timer of process p, with a pre-order walk through the heap. */
+static struct etimer *
+heap_find_process(struct process *p)
+{
+  struct etimer *t;
+
+  t = timerheap;
+  while(t != NULL) {
+    if(t->p == p) {
+      return t;
+    }
+    if(t->child != NULL) {
+      t = t->child;
+      continue;
+    }
+    /* Climb up until a timer with a next sibling is found. The parent
+       of a timer is the previous timer of its first sibling. */
+    while(t != NULL && t->next == NULL) {
+      while(t->prev != NULL && t->prev->child != t) {
+        t = t->prev;
+      }
+      t = t->prev;
+    }
+    if(t != NULL) {
+      t = t->next;
+    }
+  }
+  return NULL;
+}
+#else /* ETIMER_HEAP */
 static void
 update_time(void)
 {
@@ -76,13 +218,46 @@ update_time(void)
     next_expiration = now + tdist;
   }
 }
+#endif /* ETIMER_HEAP */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
+#if ETIMER_HEAP
+  struct etimer *t;
+#else /* ETIMER_HEAP */
   struct etimer *t, *u;
-	
+#endif /* ETIMER_HEAP */
+
   PROCESS_BEGIN();
 
+#if ETIMER_HEAP
+  timerheap = NULL;
+
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      while((t = heap_find_process(data)) != NULL) {
+        heap_remove(t);
+        t->p = PROCESS_NONE;
+      }
+      continue;
+    } else if(ev != PROCESS_EVENT_POLL) {
+      continue;
+    }
+
+    while(timerheap != NULL && timer_expired(&timerheap->timer)) {
+      t = timerheap;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+        /* The event queue is full: try again later. */
+        etimer_request_poll();
+        break;
+      }
+      heap_remove(t);
+      t->p = PROCESS_NONE;
+    }
+  }
+#else /* ETIMER_HEAP */
   timerlist = NULL;
   
   while(1) {
@@ -137,6 +312,7 @@ PROCESS_THREAD(etimer_process, ev, data)
     }
     
   }
+#endif /* ETIMER_HEAP */
   
   PROCESS_END();
 }
@@ -150,10 +326,21 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
+#if !ETIMER_HEAP
   struct etimer *t;
+#endif /* !ETIMER_HEAP */
 
   etimer_request_poll();
 
+#if ETIMER_HEAP
+  /* The expiration time may have changed, so the timer must be moved
+     if it is already pending. */
+  if(heap_contains(timer)) {
+    heap_remove(timer);
+  }
+  timer->p = PROCESS_CURRENT();
+  heap_insert(timer);
+#else /* ETIMER_HEAP */
   if(timer->p != PROCESS_NONE) {
     for(t = timerlist; t != NULL; t = t->next) {
       if(t == timer) {
@@ -171,6 +358,7 @@ add_timer(struct etimer *timer)
   timerlist = timer;
 
   update_time();
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,8 +393,18 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_HEAP
+  if(heap_contains(et)) {
+    heap_remove(et);
+    et->timer.start += timediff;
+    heap_insert(et);
+    return;
+  }
+  et->timer.start += timediff;
+#else /* ETIMER_HEAP */
   et->timer.start += timediff;
   update_time();
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -230,18 +428,31 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_HEAP
+  return timerheap != NULL;
+#else /* ETIMER_HEAP */
   return timerlist != NULL;
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
 etimer_next_expiration_time(void)
 {
+#if ETIMER_HEAP
+  return etimer_pending() ? EXPIRATION(timerheap) : 0;
+#else /* ETIMER_HEAP */
   return etimer_pending() ? next_expiration : 0;
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_HEAP
+  if(heap_contains(et)) {
+    heap_remove(et);
+  }
+#else /* ETIMER_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -265,6 +476,7 @@ etimer_stop(struct etimer *et)
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
+#endif /* ETIMER_HEAP */
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
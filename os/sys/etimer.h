@@ -64,6 +64,24 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Keep pending event timers in a min-heap
+ *
+ * By default, pending event timers are kept in an unsorted list, and
+ * setting, stopping or expiring a timer walks the whole list. With
+ * ETIMER_CONF_HEAP, they are instead kept in a pairing heap ordered
+ * by expiration time: setting a timer and getting the next expiration
+ * time take constant time, while stopping and expiring a timer take
+ * logarithmic amortized time. This costs two additional pointers per
+ * event timer, and requires that the expiration times of all pending
+ * timers are less than half the range of clock_time_t apart.
+ */
+#ifdef ETIMER_CONF_HEAP
+#define ETIMER_HEAP ETIMER_CONF_HEAP
+#else /* ETIMER_CONF_HEAP */
+#define ETIMER_HEAP 0
+#endif /* ETIMER_CONF_HEAP */
+
 /**
  * A timer.
  *
@@ -76,6 +94,15 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP
+  /* With ETIMER_HEAP, next points to the next sibling in the heap. */
+  struct etimer *child;
+  struct etimer *prev;
+  /* Set while the timer is in the heap; only meaningful when p is not
+     PROCESS_NONE, so a timer that was never set is never mistaken for
+     a pending one. */
+  uint8_t in_heap;
+#endif /* ETIMER_HEAP */
 };
 
 /**
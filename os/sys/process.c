@@ -47,6 +47,7 @@
 
 #include "contiki.h"
 #include "sys/process.h"
+#include "sys/critical.h"
 
 /*
  * Pointer to the currently running process structure.
@@ -63,13 +64,46 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_CONF_STATS
+  rtimer_clock_t time;
+#endif /* PROCESS_CONF_STATS */
+};
+
+/*
+ * A circular queue of events.
+ */
+struct event_queue {
+  struct event_data *events;
+  process_num_events_t size, nevents, fevent;
 };
 
-static process_num_events_t nevents, fevent;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+static struct event_queue event_queue = { events, PROCESS_CONF_NUMEVENTS };
+#if PROCESS_PRIORITIES
+static struct event_data high_events[PROCESS_CONF_NUMEVENTS_HIGH];
+static struct event_queue high_event_queue =
+  { high_events, PROCESS_CONF_NUMEVENTS_HIGH };
+#endif /* PROCESS_PRIORITIES */
+
+#if PROCESS_POLL_QUEUE
+/*
+ * A queue of processes to poll.
+ */
+struct poll_queue {
+  struct process *head, *tail;
+  unsigned int length;
+};
+
+#if PROCESS_PRIORITIES
+static struct poll_queue poll_queues[2];
+#else /* PROCESS_PRIORITIES */
+static struct poll_queue poll_queues[1];
+#endif /* PROCESS_PRIORITIES */
+#endif /* PROCESS_POLL_QUEUE */
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+unsigned long process_lostevents;
 #endif
 
 static volatile unsigned char poll_requested;
@@ -88,6 +122,65 @@ static void call_process(struct process *p, process_event_t ev, process_data_t d
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+#if PROCESS_POLL_QUEUE
+static struct poll_queue *
+get_poll_queue(struct process *p)
+{
+#if PROCESS_PRIORITIES
+  return &poll_queues[p->priority == PROCESS_PRIORITY_HIGH ? 0 : 1];
+#else /* PROCESS_PRIORITIES */
+  return &poll_queues[0];
+#endif /* PROCESS_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a process that needs to be polled from its poll queue. */
+static void
+remove_polled(struct process *p)
+{
+  struct poll_queue *queue;
+  struct process *q;
+  int_master_status_t status;
+
+  queue = get_poll_queue(p);
+  status = critical_enter();
+  if(queue->head == p) {
+    queue->head = p->pollnext;
+    if(queue->tail == p) {
+      queue->tail = NULL;
+    }
+    queue->length--;
+  } else {
+    for(q = queue->head; q != NULL; q = q->pollnext) {
+      if(q->pollnext == p) {
+        q->pollnext = p->pollnext;
+        if(queue->tail == p) {
+          queue->tail = q;
+        }
+        queue->length--;
+        break;
+      }
+    }
+  }
+  p->needspoll = 0;
+  critical_exit(status);
+}
+#endif /* PROCESS_POLL_QUEUE */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+static void
+account_dispatch(struct process *p, rtimer_clock_t since)
+{
+  unsigned long latency;
+
+  latency = (rtimer_clock_t)(RTIMER_NOW() - since);
+  p->dispatched++;
+  p->total_latency += latency;
+  if(latency > p->max_latency) {
+    p->max_latency = latency;
+  }
+}
+#endif /* PROCESS_CONF_STATS */
 /*---------------------------------------------------------------------------*/
 process_event_t
 process_alloc_event(void)
@@ -157,6 +250,12 @@ exit_process(struct process *p, struct process *fromprocess)
     }
   }
 
+#if PROCESS_POLL_QUEUE
+  if(p->needspoll) {
+    remove_polled(p);
+  }
+#endif /* PROCESS_POLL_QUEUE */
+
   if(p == process_list) {
     process_list = process_list->next;
   } else {
@@ -209,9 +308,13 @@ process_init(void)
 {
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  event_queue.nevents = event_queue.fevent = 0;
+#if PROCESS_PRIORITIES
+  high_event_queue.nevents = high_event_queue.fevent = 0;
+#endif /* PROCESS_PRIORITIES */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  process_lostevents = 0;
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -221,34 +324,102 @@ process_init(void)
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_POLL_QUEUE
+static void
+do_poll(void)
+{
+  struct poll_queue *queue;
+  struct process *p;
+  unsigned int lengths[sizeof(poll_queues) / sizeof(poll_queues[0])];
+  unsigned int i, n;
+  int_master_status_t status;
+
+  poll_requested = 0;
+
+  /* Only call the processes that are in the queues now: the processes
+     polled from their poll handler are called in the next round. */
+  status = critical_enter();
+  for(i = 0; i < sizeof(poll_queues) / sizeof(poll_queues[0]); i++) {
+    lengths[i] = poll_queues[i].length;
+  }
+  critical_exit(status);
+
+  for(i = 0; i < sizeof(poll_queues) / sizeof(poll_queues[0]); i++) {
+    queue = &poll_queues[i];
+    for(n = 0; n < lengths[i]; n++) {
+      status = critical_enter();
+      p = queue->head;
+      if(p != NULL) {
+        queue->head = p->pollnext;
+        if(queue->head == NULL) {
+          queue->tail = NULL;
+        }
+        queue->length--;
+        p->needspoll = 0;
+      }
+      critical_exit(status);
+      if(p == NULL) {
+        break;
+      }
+#if PROCESS_CONF_STATS
+      account_dispatch(p, p->poll_time);
+#endif /* PROCESS_CONF_STATS */
+      p->state = PROCESS_STATE_RUNNING;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+    }
+  }
+}
+#else /* PROCESS_POLL_QUEUE */
+static void
+call_polled(struct process *p)
+{
+#if PROCESS_CONF_STATS
+  account_dispatch(p, p->poll_time);
+#endif /* PROCESS_CONF_STATS */
+  p->state = PROCESS_STATE_RUNNING;
+  p->needspoll = 0;
+  call_process(p, PROCESS_EVENT_POLL, NULL);
+}
+/*---------------------------------------------------------------------------*/
 static void
 do_poll(void)
 {
   struct process *p;
 
   poll_requested = 0;
+#if PROCESS_PRIORITIES
+  /* Call the high-priority processes that need to be polled first. */
+  for(p = process_list; p != NULL; p = p->next) {
+    if(p->needspoll && p->priority == PROCESS_PRIORITY_HIGH) {
+      call_polled(p);
+    }
+  }
+#endif /* PROCESS_PRIORITIES */
   /* Call the processes that needs to be polled. */
   for(p = process_list; p != NULL; p = p->next) {
     if(p->needspoll) {
-      p->state = PROCESS_STATE_RUNNING;
-      p->needspoll = 0;
-      call_process(p, PROCESS_EVENT_POLL, NULL);
+      call_polled(p);
     }
   }
 }
+#endif /* PROCESS_POLL_QUEUE */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
  * listening processes.
  */
 /*---------------------------------------------------------------------------*/
-static void
+static int
 do_event(void)
 {
+  struct event_queue *queue;
   process_event_t ev;
   process_data_t data;
   struct process *receiver;
   struct process *p;
+#if PROCESS_CONF_STATS
+  rtimer_clock_t time;
+#endif /* PROCESS_CONF_STATS */
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -258,18 +429,31 @@ do_event(void)
    * call the poll handlers inbetween.
    */
 
-  if(nevents > 0) {
+  queue = &event_queue;
+#if PROCESS_PRIORITIES
+  /* Events to high-priority processes go first. */
+  if(high_event_queue.nevents > 0) {
+    queue = &high_event_queue;
+  }
+#endif /* PROCESS_PRIORITIES */
+
+  if(queue->nevents > 0) {
 
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    ev = queue->events[queue->fevent].ev;
 
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = queue->events[queue->fevent].data;
+    receiver = queue->events[queue->fevent].p;
+#if PROCESS_CONF_STATS
+    time = queue->events[queue->fevent].time;
+#endif /* PROCESS_CONF_STATS */
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
-    --nevents;
+    if(++queue->fevent == queue->size) {
+      queue->fevent = 0;
+    }
+    --queue->nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
@@ -281,6 +465,11 @@ do_event(void)
 	if(poll_requested) {
 	  do_poll();
 	}
+#if PROCESS_CONF_STATS
+	if(p->state & PROCESS_STATE_RUNNING) {
+	  account_dispatch(p, time);
+	}
+#endif /* PROCESS_CONF_STATS */
 	call_process(p, ev, data);
       }
     } else {
@@ -292,47 +481,70 @@ do_event(void)
 	receiver->state = PROCESS_STATE_RUNNING;
       }
 
+#if PROCESS_CONF_STATS
+      account_dispatch(receiver, time);
+#endif /* PROCESS_CONF_STATS */
       /* Make sure that the process actually is running. */
       call_process(receiver, ev, data);
     }
+    return 1;
   }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
 process_run(void)
 {
-  /* Process poll events. */
-  if(poll_requested) {
-    do_poll();
-  }
+  int i;
+
+  for(i = 0; i < PROCESS_EVENTS_PER_RUN; i++) {
+    /* Process poll events. */
+    if(poll_requested) {
+      do_poll();
+    }
 
-  /* Process one event from the queue */
-  do_event();
+    /* Process one event from the queue */
+    if(!do_event()) {
+      break;
+    }
+  }
 
-  return nevents + poll_requested;
+  return process_nevents();
 }
 /*---------------------------------------------------------------------------*/
 int
 process_nevents(void)
 {
-  return nevents + poll_requested;
+#if PROCESS_PRIORITIES
+  return event_queue.nevents + high_event_queue.nevents + poll_requested;
+#else /* PROCESS_PRIORITIES */
+  return event_queue.nevents + poll_requested;
+#endif /* PROCESS_PRIORITIES */
 }
 /*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
+  struct event_queue *queue;
   process_num_events_t snum;
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
-	   ev,PROCESS_NAME_STRING(p), nevents);
+	   ev,PROCESS_NAME_STRING(p), process_nevents());
   } else {
     PRINTF("process_post: Process '%s' posts event %d to process '%s', nevents %d\n",
 	   PROCESS_NAME_STRING(PROCESS_CURRENT()), ev,
-	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
+	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), process_nevents());
   }
 
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  queue = &event_queue;
+#if PROCESS_PRIORITIES
+  if(p != PROCESS_BROADCAST && p->priority == PROCESS_PRIORITY_HIGH) {
+    queue = &high_event_queue;
+  }
+#endif /* PROCESS_PRIORITIES */
+
+  if(queue->nevents == queue->size) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
@@ -340,24 +552,77 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
       printf("soft panic: event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
     }
 #endif /* DEBUG */
+#if PROCESS_CONF_STATS
+    process_lostevents++;
+#endif /* PROCESS_CONF_STATS */
     return PROCESS_ERR_FULL;
   }
 
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
-  ++nevents;
+  snum = queue->fevent + queue->nevents;
+  if(snum >= queue->size) {
+    snum -= queue->size;
+  }
+  queue->events[snum].ev = ev;
+  queue->events[snum].data = data;
+  queue->events[snum].p = p;
+#if PROCESS_CONF_STATS
+  queue->events[snum].time = RTIMER_NOW();
+#endif /* PROCESS_CONF_STATS */
+  ++queue->nevents;
 
 #if PROCESS_CONF_STATS
-  if(nevents > process_maxevents) {
-    process_maxevents = nevents;
+  if(process_nevents() - poll_requested > process_maxevents) {
+    process_maxevents = process_nevents() - poll_requested;
   }
 #endif /* PROCESS_CONF_STATS */
 
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+static int
+cancel_events(struct event_queue *queue, struct process *p,
+              process_event_t ev, process_data_t data)
+{
+  process_num_events_t i, src, dst, kept;
+
+  /* Compact the circular queue in place, keeping the order of the
+     events that do not match. */
+  src = dst = queue->fevent;
+  kept = 0;
+  for(i = 0; i < queue->nevents; i++) {
+    if(queue->events[src].p != p || queue->events[src].ev != ev ||
+       queue->events[src].data != data) {
+      if(dst != src) {
+        queue->events[dst] = queue->events[src];
+      }
+      if(++dst == queue->size) {
+        dst = 0;
+      }
+      kept++;
+    }
+    if(++src == queue->size) {
+      src = 0;
+    }
+  }
+  i = queue->nevents - kept;
+  queue->nevents = kept;
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+int
+process_post_cancel(struct process *p, process_event_t ev,
+                    process_data_t data)
+{
+  /* The priority of p may have changed since the events were posted,
+     so both queues are searched. */
+#if PROCESS_PRIORITIES
+  return cancel_events(&event_queue, p, ev, data) +
+    cancel_events(&high_event_queue, p, ev, data);
+#else /* PROCESS_PRIORITIES */
+  return cancel_events(&event_queue, p, ev, data);
+#endif /* PROCESS_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
@@ -373,12 +638,57 @@ process_poll(struct process *p)
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_POLL_QUEUE
+      struct poll_queue *queue;
+      int_master_status_t status;
+
+      status = critical_enter();
+      if(!p->needspoll) {
+#if PROCESS_CONF_STATS
+        p->poll_time = RTIMER_NOW();
+#endif /* PROCESS_CONF_STATS */
+        p->needspoll = 1;
+        p->pollnext = NULL;
+        queue = get_poll_queue(p);
+        if(queue->tail != NULL) {
+          queue->tail->pollnext = p;
+        } else {
+          queue->head = p;
+        }
+        queue->tail = p;
+        queue->length++;
+      }
+      critical_exit(status);
+#else /* PROCESS_POLL_QUEUE */
+#if PROCESS_CONF_STATS
+      if(!p->needspoll) {
+        p->poll_time = RTIMER_NOW();
+      }
+#endif /* PROCESS_CONF_STATS */
       p->needspoll = 1;
+#endif /* PROCESS_POLL_QUEUE */
       poll_requested = 1;
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_PRIORITIES
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+#if PROCESS_POLL_QUEUE
+  /* Move a process waiting for a poll to its new poll queue. */
+  if(p->needspoll) {
+    remove_polled(p);
+    p->priority = priority;
+    process_poll(p);
+    return;
+  }
+#endif /* PROCESS_POLL_QUEUE */
+  p->priority = priority;
+}
+#endif /* PROCESS_PRIORITIES */
+/*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
 {
@@ -88,6 +88,52 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \brief Keep the processes to poll in a queue
+ *
+ * By default, every poll round walks the whole list of processes to
+ * find those that need to be polled. With PROCESS_CONF_POLL_QUEUE,
+ * process_poll() appends the process to a queue instead, so that a
+ * poll round only visits the polled processes.
+ */
+#ifdef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_POLL_QUEUE PROCESS_CONF_POLL_QUEUE
+#else /* PROCESS_CONF_POLL_QUEUE */
+#define PROCESS_POLL_QUEUE 0
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+/**
+ * \brief The maximum number of events delivered by process_run()
+ */
+#ifdef PROCESS_CONF_EVENTS_PER_RUN
+#define PROCESS_EVENTS_PER_RUN PROCESS_CONF_EVENTS_PER_RUN
+#else /* PROCESS_CONF_EVENTS_PER_RUN */
+#define PROCESS_EVENTS_PER_RUN 1
+#endif /* PROCESS_CONF_EVENTS_PER_RUN */
+
+/**
+ * \brief Support a high-priority class of processes
+ *
+ * With PROCESS_CONF_PRIORITIES, the processes set to
+ * PROCESS_PRIORITY_HIGH with process_set_priority() are polled before
+ * the others, and the events posted to them are kept in a separate
+ * queue of PROCESS_CONF_NUMEVENTS_HIGH events, which is served before
+ * the queue of the other events. Broadcast events always go to the
+ * queue of the other events.
+ */
+#ifdef PROCESS_CONF_PRIORITIES
+#define PROCESS_PRIORITIES PROCESS_CONF_PRIORITIES
+#else /* PROCESS_CONF_PRIORITIES */
+#define PROCESS_PRIORITIES 0
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH 8
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,6 +369,20 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_PRIORITIES
+  unsigned char priority;
+#endif /* PROCESS_PRIORITIES */
+#if PROCESS_POLL_QUEUE
+  struct process *pollnext;
+#endif /* PROCESS_POLL_QUEUE */
+#if PROCESS_CONF_STATS
+  /* The number of events and polls delivered to the process, and the
+     total and maximum time that they waited, in rtimer ticks. */
+  unsigned long dispatched;
+  unsigned long total_latency;
+  unsigned long max_latency;
+  unsigned long poll_time;
+#endif /* PROCESS_CONF_STATS */
 };
 
 /**
@@ -377,6 +437,24 @@ int process_post(struct process *p, process_event_t ev, process_data_t data);
 void process_post_synch(struct process *p,
                         process_event_t ev, process_data_t data);
 
+/**
+ * Remove pending events from the event queue.
+ *
+ * \param p The process to which the events were posted.
+ *
+ * \param ev The event that was posted.
+ *
+ * \param data The auxiliary data that was posted with the event.
+ *
+ * \return The number of events that were removed.
+ *
+ *             This function discards events that have been posted
+ *             with process_post() but not yet delivered, so that
+ *             their data can be released before the receiver sees it.
+ */
+int process_post_cancel(struct process *p,
+                        process_event_t ev, process_data_t data);
+
 /**
  * \brief      Cause a process to exit
  * \param p    The process that is to be exited
@@ -489,10 +567,11 @@ void process_init(void);
  *
  * This function should be called repeatedly from the main() program
  * to actually run the Contiki system. It calls the necessary poll
- * handlers, and processes one event. The function returns the number
- * of events that are waiting in the event queue so that the caller
- * may choose to put the CPU to sleep when there are no pending
- * events.
+ * handlers, and processes one event, or up to PROCESS_EVENTS_PER_RUN
+ * events with the poll handlers called before each of them. The
+ * function returns the number of events that are waiting in the event
+ * queue so that the caller may choose to put the CPU to sleep when
+ * there are no pending events.
  *
  * \return The number of events that are currently waiting in the
  * event queue.
@@ -519,6 +598,25 @@ int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+#if PROCESS_PRIORITIES
+/**
+ * Set the priority class of a process.
+ *
+ * \param p The process.
+ * \param priority PROCESS_PRIORITY_HIGH or PROCESS_PRIORITY_NORMAL.
+ */
+void process_set_priority(struct process *p, unsigned char priority);
+#else /* PROCESS_PRIORITIES */
+#define process_set_priority(p, priority)
+#endif /* PROCESS_PRIORITIES */
+
+#if PROCESS_CONF_STATS
+/** The maximum number of events that have been waiting at once. */
+extern process_num_events_t process_maxevents;
+/** The number of events that could not be posted, as the queue was full. */
+extern unsigned long process_lostevents;
+#endif /* PROCESS_CONF_STATS */
+
 /** @} */
 
 extern struct process *process_list;
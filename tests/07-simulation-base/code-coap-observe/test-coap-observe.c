@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Tests of CoAP observe notifications rendered once for all
+ *         observers, with congestion control and a single transaction,
+ *         so that a notification can only be sent in place of the
+ *         pending confirmable one.
+ */
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-observe.h"
+#include "coap-transactions.h"
+#include "services/unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(coap_observe_test_process, "CoAP observe test process");
+AUTOSTART_PROCESSES(&coap_observe_test_process);
+/*---------------------------------------------------------------------------*/
+#define OBSERVER_URI "coap://[fd00::2]"
+
+static void res_get_handler(coap_message_t *request, coap_message_t *response,
+                            uint8_t *buffer, uint16_t preferred_size,
+                            int32_t *offset);
+
+EVENT_RESOURCE(res_observed, "obs", res_get_handler, NULL, NULL, NULL, NULL);
+
+static coap_endpoint_t observer;
+static const uint8_t token[] = { 0xbe, 0xef };
+/* Make the notification too large to serialize. */
+static uint8_t render_fails;
+static char long_path[COAP_MAX_HEADER_SIZE + 1];
+
+static uint16_t pending_mid;
+static uint16_t pending_len;
+static uint8_t pending_message[COAP_MAX_PACKET_SIZE];
+/*---------------------------------------------------------------------------*/
+void
+print_test_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+res_get_handler(coap_message_t *request, coap_message_t *response,
+                uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  if(render_fails) {
+    coap_set_header_location_path(response, long_path);
+  }
+  coap_set_payload(response, "22.5", 4);
+}
+/*---------------------------------------------------------------------------*/
+static int
+message_type(const coap_transaction_t *t)
+{
+  return (t->message[0] & COAP_HEADER_TYPE_MASK) >> COAP_HEADER_TYPE_POSITION;
+}
+/*---------------------------------------------------------------------------*/
+/* Notify the observer, and return the MID the notification takes. */
+static uint16_t
+notify(void)
+{
+  uint16_t mid;
+
+  mid = coap_get_mid() + 1;
+  coap_notify_observers(&res_observed);
+  return mid;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_register, "Register an observer");
+UNIT_TEST(test_register)
+{
+  coap_message_t request[1];
+  coap_message_t response[1];
+
+  UNIT_TEST_BEGIN();
+
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, coap_get_mid());
+  coap_set_header_uri_path(request, "obs");
+  coap_set_header_observe(request, 0);
+  coap_set_token(request, token, sizeof(token));
+  coap_set_src_endpoint(request, &observer);
+  coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, request->mid);
+
+  coap_observe_handler(&res_observed, request, response);
+  UNIT_TEST_ASSERT(coap_has_observers("obs"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_notify, "Send a confirmable notification");
+UNIT_TEST(test_notify)
+{
+  coap_transaction_t *t;
+
+  UNIT_TEST_BEGIN();
+
+  pending_mid = notify();
+  t = coap_get_transaction_by_mid(pending_mid);
+  UNIT_TEST_ASSERT(t != NULL);
+  UNIT_TEST_ASSERT(message_type(t) == COAP_TYPE_CON);
+  UNIT_TEST_ASSERT(memcmp(t->message + COAP_HEADER_LEN, token,
+                          sizeof(token)) == 0);
+
+  pending_len = t->message_len;
+  memcpy(pending_message, t->message, pending_len);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_render_fails,
+                   "Failed rendering keeps the pending notification");
+UNIT_TEST(test_render_fails)
+{
+  coap_transaction_t *t;
+  uint16_t mid;
+
+  UNIT_TEST_BEGIN();
+
+  render_fails = 1;
+  mid = notify();
+  render_fails = 0;
+
+  UNIT_TEST_ASSERT(coap_get_transaction_by_mid(mid) == NULL);
+  t = coap_get_transaction_by_mid(pending_mid);
+  UNIT_TEST_ASSERT(t != NULL);
+  UNIT_TEST_ASSERT(t->message_len == pending_len);
+  UNIT_TEST_ASSERT(memcmp(t->message, pending_message, pending_len) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_replace, "Replace the pending notification");
+UNIT_TEST(test_replace)
+{
+  coap_transaction_t *t;
+  uint16_t mid;
+
+  UNIT_TEST_BEGIN();
+
+  mid = notify();
+  UNIT_TEST_ASSERT(coap_get_transaction_by_mid(pending_mid) == NULL);
+  t = coap_get_transaction_by_mid(mid);
+  UNIT_TEST_ASSERT(t != NULL);
+  UNIT_TEST_ASSERT(message_type(t) == COAP_TYPE_CON);
+  UNIT_TEST_ASSERT(t->message_len == pending_len);
+  /* Only the MID and the value of the Observe option differ. */
+  UNIT_TEST_ASSERT(memcmp(t->message + 4, pending_message + 4,
+                          sizeof(token)) == 0);
+  UNIT_TEST_ASSERT(memcmp(t->message, pending_message, pending_len) != 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_observe_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  coap_engine_init();
+  coap_activate_resource(&res_observed, "obs");
+  coap_endpoint_parse(OBSERVER_URI, strlen(OBSERVER_URI), &observer);
+  memset(long_path, 'a', sizeof(long_path) - 1);
+
+  UNIT_TEST_RUN(test_register);
+  UNIT_TEST_RUN(test_notify);
+  UNIT_TEST_RUN(test_render_fails);
+  UNIT_TEST_RUN(test_replace);
+
+  printf("=check-me= DONE\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
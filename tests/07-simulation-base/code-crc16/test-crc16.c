@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "services/unit-test/unit-test.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(crc16_test_process, "CRC16 test process");
+AUTOSTART_PROCESSES(&crc16_test_process);
+/*---------------------------------------------------------------------------*/
+static unsigned char buf[512 + 8];
+/*---------------------------------------------------------------------------*/
+void
+print_test_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The bit-serial algorithm, used when CRC16_TABLE_SLICES is 0 */
+static unsigned short
+reference_crc16(const unsigned char *data, int len, unsigned short acc)
+{
+  int i;
+  int bit;
+
+  for(i = 0; i < len; i++) {
+    acc ^= data[i];
+    for(bit = 0; bit < 8; bit++) {
+      acc = (acc & 1) ? (acc >> 1) ^ 0x8408 : acc >> 1;
+    }
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_check_value, "Check value");
+UNIT_TEST(test_check_value)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(crc16_data((const unsigned char *)"123456789", 9, 0) ==
+                   0x2189);
+  UNIT_TEST_ASSERT(crc16_data(buf, 0, 0x1234) == 0x1234);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_add, "crc16_add against reference");
+UNIT_TEST(test_add)
+{
+  unsigned short acc;
+  unsigned char b;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 256; i++) {
+    b = i;
+    acc = random_rand();
+    UNIT_TEST_ASSERT(crc16_add(b, acc) == reference_crc16(&b, 1, acc));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_data, "crc16_data against reference");
+UNIT_TEST(test_data)
+{
+  unsigned short acc;
+  int offset;
+  int len;
+
+  UNIT_TEST_BEGIN();
+
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len <= sizeof(buf) - 8; len++) {
+      acc = random_rand();
+      UNIT_TEST_ASSERT(crc16_data(buf + offset, len, acc) ==
+                       reference_crc16(buf + offset, len, acc));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_split, "crc16_data in pieces");
+UNIT_TEST(test_split)
+{
+  unsigned short whole;
+  unsigned short acc;
+  int split;
+
+  UNIT_TEST_BEGIN();
+
+  whole = crc16_data(buf, 300, 0);
+  for(split = 0; split <= 300; split++) {
+    acc = crc16_data(buf, split, 0);
+    UNIT_TEST_ASSERT(crc16_data(buf + split, 300 - split, acc) == whole);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crc16_test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test (CRC16 table slices: %d)\n", CRC16_TABLE_SLICES);
+  printf("---\n");
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+
+  UNIT_TEST_RUN(test_check_value);
+  UNIT_TEST_RUN(test_add);
+  UNIT_TEST_RUN(test_data);
+  UNIT_TEST_RUN(test_split);
+
+  printf("=check-me= DONE\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
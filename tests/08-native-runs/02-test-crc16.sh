@@ -0,0 +1,46 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/tests/07-simulation-base/code-crc16/
+CODE=test-crc16
+
+rm -f $CODE.log $CODE.err make.log make.err
+
+# Run the test once for each CRC16 implementation
+for SLICES in 0 1 4 8 ; do
+  echo "Starting native node (CRC16_CONF_TABLE_SLICES=$SLICES)"
+  make -C $CODE_DIR TARGET=native clean >> make.log 2>> make.err
+  make -C $CODE_DIR TARGET=native DEFINES=CRC16_CONF_TABLE_SLICES=$SLICES >> make.log 2>> make.err
+  $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err &
+  CPID=$!
+  sleep 2
+
+  echo "Closing native node"
+  kill_bg $CPID
+done
+make -C $CODE_DIR TARGET=native clean >> make.log 2>> make.err
+
+if grep -q "=check-me= FAILED" $CODE.log || [ $(grep -c "=check-me= DONE" $CODE.log) -ne 4 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.log $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
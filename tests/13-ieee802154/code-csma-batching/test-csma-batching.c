@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         CSMA saturation test. Node 2 sends to node 1 faster than the
+ *         channel allows, so that its CSMA queue is always full, and
+ *         node 1 reports the goodput. With transmit batching, the
+ *         queued packets are sent back-to-back instead of with a new
+ *         backoff each.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/nullnet/nullnet.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PAYLOAD_LEN      80
+#define PACKETS_PER_TICK 4
+#define START_DELAY      (5 * CLOCK_SECOND)
+#define SEND_DURATION    (25 * CLOCK_SECOND)
+#define MEASURE_DURATION (20 * CLOCK_SECOND)
+
+static linkaddr_t receiver_addr = {{ 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }};
+
+PROCESS(test_csma_batching_process, "CSMA batching test");
+AUTOSTART_PROCESSES(&test_csma_batching_process);
+
+static uint8_t payload[PAYLOAD_LEN];
+static unsigned long received;
+static clock_time_t measure_start;
+static uint8_t measure_done;
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(const void *data, uint16_t len,
+               const linkaddr_t *src, const linkaddr_t *dest)
+{
+  clock_time_t duration;
+
+  if(len != PAYLOAD_LEN || measure_done) {
+    return;
+  }
+  if(received == 0) {
+    measure_start = clock_time();
+  }
+  received++;
+  duration = clock_time() - measure_start;
+  if(duration >= MEASURE_DURATION) {
+    measure_done = 1;
+    printf("=check-me= DONE batch max len %u, %lu packets in %lu ms, "
+           "goodput %lu bytes/s\n",
+           (unsigned)CSMA_CONF_TX_BATCH_MAX_LEN, received,
+           (unsigned long)(duration * 1000 / CLOCK_SECOND),
+           (unsigned long)(received * PAYLOAD_LEN * CLOCK_SECOND / duration));
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_csma_batching_process, ev, data)
+{
+  static struct etimer periodic_timer;
+  static clock_time_t send_end;
+  static uint8_t i;
+
+  PROCESS_BEGIN();
+
+  nullnet_set_input_callback(input_callback);
+
+  if(!linkaddr_cmp(&receiver_addr, &linkaddr_node_addr)) {
+    nullnet_buf = payload;
+    nullnet_len = sizeof(payload);
+    etimer_set(&periodic_timer, START_DELAY);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+    send_end = clock_time() + SEND_DURATION;
+    while(clock_time() < send_end) {
+      /* More than the channel can carry: packets that do not fit in
+         the queue are dropped by CSMA */
+      for(i = 0; i < PACKETS_PER_TICK; i++) {
+        NETSTACK_NETWORK.output(&receiver_addr);
+      }
+      etimer_set(&periodic_timer, 1);
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+    }
+    printf("=check-me= DONE sending\n");
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         TSCH burst test. Node 2 queues bursts of packets to the
+ *         coordinator, node 1, which reports how long each burst took
+ *         to be received. With bursts enabled, the packets that follow
+ *         the first one are sent in the slots that follow it, instead
+ *         of one per slotframe.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/nullnet/nullnet.h"
+#include "net/mac/tsch/tsch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_BURSTS     5
+#define BURST_LEN      8
+#define BURST_INTERVAL (10 * CLOCK_SECOND)
+
+static linkaddr_t coordinator_addr = {{ 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }};
+
+struct test_packet {
+  uint8_t burst;
+  uint8_t index;
+};
+
+PROCESS(test_tsch_burst_process, "TSCH burst test");
+AUTOSTART_PROCESSES(&test_tsch_burst_process);
+
+static unsigned received;
+static unsigned bursts_received;
+static clock_time_t burst_start;
+static clock_time_t max_duration;
+static clock_time_t total_duration;
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(const void *data, uint16_t len,
+               const linkaddr_t *src, const linkaddr_t *dest)
+{
+  struct test_packet packet;
+  clock_time_t duration;
+
+  if(len != sizeof(packet)) {
+    return;
+  }
+  memcpy(&packet, data, sizeof(packet));
+  if(packet.index == 0) {
+    burst_start = clock_time();
+    received = 0;
+  }
+  received++;
+  if(packet.index == BURST_LEN - 1) {
+    duration = clock_time() - burst_start;
+    printf("=check-me= burst %u: %u of %u packets in %lu ms\n",
+           packet.burst, received, BURST_LEN,
+           (unsigned long)(duration * 1000 / CLOCK_SECOND));
+    if(received != BURST_LEN) {
+      printf("=check-me= FAILED: packets lost\n");
+    }
+    total_duration += duration;
+    if(duration > max_duration) {
+      max_duration = duration;
+    }
+    if(++bursts_received == NUM_BURSTS) {
+      printf("=check-me= DONE burst max len %u, slot %u us, "
+             "average %lu ms, max %lu ms\n",
+             (unsigned)TSCH_BURST_MAX_LEN,
+             (unsigned)TSCH_CONF_DEFAULT_TIMESLOT_LENGTH,
+             (unsigned long)(total_duration * 1000 / CLOCK_SECOND / NUM_BURSTS),
+             (unsigned long)(max_duration * 1000 / CLOCK_SECOND));
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_tsch_burst_process, ev, data)
+{
+  static struct etimer periodic_timer;
+  static struct test_packet packet;
+
+  PROCESS_BEGIN();
+
+  tsch_set_coordinator(linkaddr_cmp(&coordinator_addr, &linkaddr_node_addr));
+  nullnet_set_input_callback(input_callback);
+
+  if(!linkaddr_cmp(&coordinator_addr, &linkaddr_node_addr)) {
+    nullnet_buf = (uint8_t *)&packet;
+    nullnet_len = sizeof(packet);
+    etimer_set(&periodic_timer, BURST_INTERVAL);
+    /* Wait until we have joined the network */
+    while(!tsch_is_associated) {
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+      etimer_reset(&periodic_timer);
+    }
+    for(packet.burst = 0; packet.burst < NUM_BURSTS; packet.burst++) {
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+      etimer_reset(&periodic_timer);
+      /* Queue the whole burst at once */
+      for(packet.index = 0; packet.index < BURST_LEN; packet.index++) {
+        NETSTACK_NETWORK.output(&coordinator_addr);
+      }
+    }
+    printf("=check-me= DONE sending\n");
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
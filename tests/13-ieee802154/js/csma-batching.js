@@ -0,0 +1,44 @@
+TIMEOUT(120000, log.testFailed());
+
+/* The receiver reports the goodput of a saturated CSMA link. Packets
+   dropped by the sender when its queue is full are expected, the test
+   fails if nothing was received.
+   Without batching, each packet waits for a backoff of 0 to 41 ms in
+   Cooja (7 periods of 6 ms), which alone caps the goodput of 80-byte
+   packets at about 3900 bytes/s. With batching, only every eighth
+   packet waits for one, so the goodput must be well above that cap. */
+var min_batching_goodput = 5000;
+var failed = false;
+var done = 0;
+
+while(done < sim.getMotes().length) {
+    YIELD();
+
+    log.log(time + " " + "node-" + id + " "+ msg + "\n");
+
+    if(msg.contains("=check-me=") == false) {
+        continue;
+    }
+
+    if(msg.contains("FAILED")) {
+        failed = true;
+    }
+
+    if(msg.contains("DONE")) {
+        var batch = msg.match(/batch max len (\d+)/);
+        var goodput = msg.match(/goodput (\d+) bytes/);
+        if(goodput != null && parseInt(goodput[1]) == 0) {
+            failed = true;
+        }
+        if(batch != null && goodput != null && parseInt(batch[1]) > 1
+           && parseInt(goodput[1]) < min_batching_goodput) {
+            log.log("goodput " + goodput[1] + " bytes/s with batching\n");
+            failed = true;
+        }
+        done++;
+    }
+}
+if(failed) {
+    log.testFailed();
+}
+log.testOK();
@@ -0,0 +1,38 @@
+TIMEOUT(300000, log.testFailed());
+
+/* With bursts, the packets of a burst are sent in consecutive slots,
+   and a burst of 8 packets is received within a few slotframes of the
+   6TiSCH minimal schedule. Without bursts, it takes one slotframe per
+   packet. */
+var max_burst_ms = 250;
+var failed = false;
+var done = 0;
+
+while(done < sim.getMotes().length) {
+    YIELD();
+
+    log.log(time + " " + "node-" + id + " "+ msg + "\n");
+
+    if(msg.contains("=check-me=") == false) {
+        continue;
+    }
+
+    if(msg.contains("FAILED")) {
+        failed = true;
+    }
+
+    if(msg.contains("DONE")) {
+        var burst = msg.match(/burst max len (\d+)/);
+        var max = msg.match(/max (\d+) ms/);
+        if(burst != null && max != null
+           && parseInt(burst[1]) > 1 && parseInt(max[1]) > max_burst_ms) {
+            log.log("bursts took up to " + max[1] + " ms\n");
+            failed = true;
+        }
+        done++;
+    }
+}
+if(failed) {
+    log.testFailed();
+}
+log.testOK();
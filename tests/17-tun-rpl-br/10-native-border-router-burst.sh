@@ -0,0 +1,72 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=10-native-border-router-burst
+
+BR_DIR=$CONTIKI/examples/rpl-border-router
+PORT=60123
+
+# Burst of UDP packets from the host to a node behind the BR, as large as
+# the BR forwards: the 1280-byte MTU less the RPL option the root inserts
+COUNT=32
+SIZE=1224
+
+# Runs a native BR that drains tun in batches, with the given SLIP codec,
+# against a fake slip-radio that sends a burst through it
+# $1: SLIP_DEV_CONF_BULK
+burst() {
+  local NAME=$BASENAME-bulk$1
+  local DEFINES=TUN_BATCH_CONF_SIZE=16,SLIP_DEV_CONF_BULK=$1,QUEUEBUF_CONF_NUM=16
+
+  echo "Building the border router, SLIP_DEV_CONF_BULK=$1"
+  make -C $BR_DIR TARGET=native clean > /dev/null 2>&1
+  if ! make -C $BR_DIR TARGET=native WERROR=0 DEFINES=$DEFINES > $NAME.make.log 2>&1 ; then
+    cat $NAME.make.log
+    echo "$NAME: build failed" >> $BASENAME.log
+    return
+  fi
+
+  echo "Starting the fake slip-radio and the border router"
+  python3 fake-slip-radio.py $PORT $COUNT $SIZE > $NAME.radio.log 2>&1 &
+  RPID=$!
+  sleep 1
+  sudo $BR_DIR/border-router.native -a 127.0.0.1 -p $PORT fd01::1/64 > $NAME.br.log 2>&1 &
+  BRPID=$!
+
+  # The radio exits once the BR has been idle after the burst, or has exited
+  wait $RPID
+  sleep 1
+  if ps -p $BRPID > /dev/null ; then
+    kill_bg $BRPID
+  fi
+
+  FRAMES=$(sed -n 's/^Frames \([0-9]*\)$/\1/p' $NAME.radio.log)
+  echo "$NAME: ${FRAMES:-no} frames" | tee -a $BASENAME.log
+  if [ "${FRAMES:-0}" -eq 0 ] ; then
+    echo "==== $NAME.radio.log ====" ; cat $NAME.radio.log
+    echo "==== $NAME.br.log ====" ; tail -20 $NAME.br.log
+    echo "$NAME: FAIL" >> $BASENAME.log
+  fi
+  cp $NAME.br.log /tmp/ ;   rm -f $NAME.make.log $NAME.radio.log $NAME.br.log
+}
+
+rm -f $BASENAME.log
+burst 0
+burst 1
+make -C $BR_DIR TARGET=native clean > /dev/null 2>&1
+
+if grep -q "FAIL" $BASENAME.log ; then
+  cat $BASENAME.log
+  printf "%-32s TEST FAIL\n" "$BASENAME" | tee $BASENAME.testlog;
+else
+  printf "%-32s TEST OK\n" "$BASENAME" | tee $BASENAME.testlog;
+fi
+
+rm -f $BASENAME.log
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+A fake slip-radio for the native border router.
+
+Listens for the border router on a TCP port, joins a single node to its
+RPL DODAG, then sends a burst of UDP packets to that node through the tun
+interface. Every frame the border router sends to the radio is acked.
+Exits when no frame has arrived for a few seconds, printing the number of
+frames received for the burst, or as soon as the border router has exited.
+
+Usage: fake-slip-radio.py <port> <packet count> <UDP payload length>
+"""
+
+import socket
+import struct
+import sys
+import threading
+import time
+
+END, ESC, ESC_END, ESC_ESC = 0xc0, 0xdb, 0xdc, 0xdd
+
+# Not the usual fd00::/64, which the host may already route elsewhere
+PREFIX = 'fd01::'
+ROOT_LL = bytes([0x00, 0x12, 0x4b, 0x00, 0x00, 0x00, 0x00, 0x01])
+NODE_LL = bytes([0x00, 0x12, 0x4b, 0x00, 0x00, 0x00, 0x00, 0x02])
+ROOT_IID = '212:4b00:0:1'
+NODE_IID = '212:4b00:0:2'
+PAN_ID = 0xabcd
+
+IDLE_TIMEOUT = 5
+
+
+def slip(data):
+    out = bytearray()
+    for b in data:
+        if b == END:
+            out += bytes([ESC, ESC_END])
+        elif b == ESC:
+            out += bytes([ESC, ESC_ESC])
+        else:
+            out.append(b)
+    out.append(END)
+    return bytes(out)
+
+
+def checksum(data):
+    if len(data) % 2:
+        data += b'\0'
+    s = sum(struct.unpack('!%dH' % (len(data) // 2), data))
+    while s >> 16:
+        s = (s & 0xffff) + (s >> 16)
+    return ~s & 0xffff
+
+
+def addr(a):
+    return socket.inet_pton(socket.AF_INET6, a)
+
+
+def icmp6(src, dst, icmp_type, code, body):
+    msg = bytes([icmp_type, code, 0, 0]) + body
+    pseudo = src + dst + struct.pack('!I3xB', len(msg), 58)
+    msg = msg[:2] + struct.pack('!H', checksum(pseudo + msg)) + msg[4:]
+    return struct.pack('!IHBB', 6 << 28, len(msg), 58, 64) + src + dst + msg
+
+
+class Radio:
+    def __init__(self, conn):
+        self.conn = conn
+        self.seq = 0
+        self.lock = threading.Lock()
+
+    def send(self, data):
+        with self.lock:
+            self.conn.sendall(slip(data))
+
+    def send_from_node(self, ip):
+        """Sends an uncompressed IPv6 packet from the node to the root"""
+        self.seq = (self.seq + 1) & 0xff
+        self.send(bytes([0x41, 0xcc, self.seq]) + struct.pack('<H', PAN_ID) +
+                  ROOT_LL[::-1] + NODE_LL[::-1] + bytes([0x41]) + ip)
+
+
+def join(radio):
+    # A unicast DIS adds the node to the neighbor table of the root
+    radio.send_from_node(icmp6(addr('fe80::' + NODE_IID),
+                               addr('fe80::' + ROOT_IID), 155, 0x00, bytes(2)))
+    time.sleep(0.5)
+    # A non-storing DAO gives the root a route to the node
+    target = bytes([5, 18, 0, 128]) + addr(PREFIX + NODE_IID)
+    transit = bytes([6, 20, 0, 0, 0, 30]) + addr(PREFIX + ROOT_IID)
+    radio.send_from_node(icmp6(addr(PREFIX + NODE_IID),
+                               addr(PREFIX + ROOT_IID), 155, 0x02,
+                               bytes([0, 0, 0, 1]) + target + transit))
+
+
+def burst(radio, count, size, started):
+    time.sleep(2)
+    join(radio)
+    time.sleep(2)
+    started.set()
+    s = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    payload = bytes((i * 7) & 0xff for i in range(size))
+    for i in range(count):
+        s.sendto(payload, (PREFIX + NODE_IID, 5678))
+    print('Sent %d packets of %d bytes' % (count, size), flush=True)
+
+
+def main():
+    port, count, size = int(sys.argv[1]), int(sys.argv[2]), int(sys.argv[3])
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('127.0.0.1', port))
+    server.listen(1)
+    server.settimeout(60)
+    conn, _ = server.accept()
+    conn.settimeout(IDLE_TIMEOUT)
+    radio = Radio(conn)
+
+    started = threading.Event()
+    frames = 0
+    frame = bytearray()
+    escaped = False
+    joining = False
+    while True:
+        try:
+            data = conn.recv(65536)
+        except socket.timeout:
+            if started.is_set():
+                break
+            continue
+        if not data:
+            # The border router has exited
+            print('Connection closed', flush=True)
+            return
+        for b in data:
+            if escaped:
+                frame.append(END if b == ESC_END else ESC)
+                escaped = False
+            elif b == ESC:
+                escaped = True
+            elif b != END:
+                frame.append(b)
+            elif frame[:2] == b'?M':
+                radio.send(b'!M' + ROOT_LL)
+                if not joining:
+                    joining = True
+                    threading.Thread(target=burst, daemon=True,
+                                     args=(radio, count, size, started)).start()
+                frame = bytearray()
+            else:
+                if frame[:2] == b'!S':
+                    # Acks the frame as sent, with one transmission
+                    radio.send(b'!R' + bytes([frame[2], 0, 1]))
+                    if started.is_set():
+                        frames += 1
+                frame = bytearray()
+    print('Frames %d' % frames, flush=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -62,6 +62,21 @@
 #ifndef BAUDRATE
 #define BAUDRATE B115200
 #endif
+
+/*
+ * Scan for the SLIP special characters with memchr() and copy the runs of
+ * plain bytes in between as a whole, instead of one byte at a time.
+ */
+#ifndef SLIP_BULK
+#define SLIP_BULK 1
+#endif
+
+#if SLIP_BULK
+#define SLIP_BUF_SIZE 16384
+#define SLIP_READ_SIZE 4096
+#else
+#define SLIP_BUF_SIZE 2000
+#endif
 speed_t b_rate = BAUDRATE;
 
 int verbose = 1;
@@ -165,6 +180,235 @@ is_sensible_string(const unsigned char *s, int len)
   return 1;
 }
 
+static union {
+  unsigned char inbuf[2000];
+} uip;
+static int inbufptr = 0;
+
+/*
+ * Handle a complete SLIP frame: commands from the radio, debug output and
+ * packets to write to tun.
+ */
+static void
+slip_frame_to_tun(int outfd)
+{
+  int i;
+
+  if(uip.inbuf[0] == '!') {
+    if(uip.inbuf[1] == 'M') {
+      /* Read gateway MAC address and autoconfigure tap0 interface */
+      char macs[24];
+      int i, pos;
+      for(i = 0, pos = 0; i < 16; i++) {
+        macs[pos++] = uip.inbuf[2 + i];
+        if((i & 1) == 1 && i < 14) {
+          macs[pos++] = ':';
+        }
+      }
+      if(timestamp) stamptime();
+      macs[pos] = '\0';
+//	  printf("*** Gateway's MAC address: %s\n", macs);
+      fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s down", tundev);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s up", tundev);
+    }
+  } else if(uip.inbuf[0] == '?') {
+    if(uip.inbuf[1] == 'P') {
+      /* Prefix info requested */
+      struct in6_addr addr;
+      int i;
+      char *s = strchr(ipaddr, '/');
+      if(s != NULL) {
+        *s = '\0';
+      }
+      inet_pton(AF_INET6, ipaddr, &addr);
+      if(timestamp) stamptime();
+      fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
+	     ipaddr,
+	     addr.s6_addr[0], addr.s6_addr[1],
+	     addr.s6_addr[2], addr.s6_addr[3],
+	     addr.s6_addr[4], addr.s6_addr[5],
+	     addr.s6_addr[6], addr.s6_addr[7]);
+      slip_send(slipfd, '!');
+      slip_send(slipfd, 'P');
+      for(i = 0; i < 8; i++) {
+        /* need to call the slip_send_char for stuffing */
+        slip_send_char(slipfd, addr.s6_addr[i]);
+      }
+      slip_send(slipfd, SLIP_END);
+    }
+#define DEBUG_LINE_MARKER '\r'
+  } else if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(uip.inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(uip.inbuf, inbufptr)) {
+    if(verbose==1) {   /* strings already echoed below for verbose>1 */
+      if (timestamp) stamptime();
+      fwrite(uip.inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(verbose>2) {
+      if (timestamp) stamptime();
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if (verbose>4) {
+#if WIRESHARK_IMPORT_FORMAT
+        printf("0000");
+            for(i = 0; i < inbufptr; i++) printf(" %02x",uip.inbuf[i]);
+#else
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", uip.inbuf[i]);
+          if((i & 3) == 3) printf(" ");
+          if((i & 15) == 15) printf("\n         ");
+        }
+#endif
+        printf("\n");
+      }
+    }
+    if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
+      err(1, "serial_to_tun: write");
+    }
+  }
+}
+
+#if SLIP_BULK
+/* Where the next END and ESC are in a buffer that is being scanned */
+struct slip_scan {
+  const unsigned char *end;
+  const unsigned char *next_end;
+  const unsigned char *next_esc;
+};
+
+static const unsigned char *
+find_byte(const unsigned char *p, unsigned char c, const unsigned char *end)
+{
+  const unsigned char *q = memchr(p, c, end - p);
+  return q != NULL ? q : end;
+}
+
+static void
+slip_scan_init(struct slip_scan *scan, const unsigned char *p,
+               const unsigned char *end)
+{
+  scan->end = end;
+  scan->next_end = find_byte(p, SLIP_END, end);
+  scan->next_esc = find_byte(p, SLIP_ESC, end);
+}
+
+/*
+ * Return the first END or ESC at or after p, or the end of the buffer.
+ * Each memchr() result is kept until p has moved past it.
+ */
+static const unsigned char *
+slip_scan_next(struct slip_scan *scan, const unsigned char *p)
+{
+  if(scan->next_end < p) {
+    scan->next_end = find_byte(p, SLIP_END, scan->end);
+  }
+  if(scan->next_esc < p) {
+    scan->next_esc = find_byte(p, SLIP_ESC, scan->end);
+  }
+  return scan->next_end < scan->next_esc ? scan->next_end : scan->next_esc;
+}
+
+static int dropping;
+
+static void
+slip_input_append(const unsigned char *data, int len)
+{
+  if(dropping || len == 0) {
+    return;
+  }
+  if(inbufptr + len > sizeof(uip.inbuf)) {
+    if(timestamp) stamptime();
+    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr + len);
+    /* Skip the rest of the packet, up to the next END */
+    inbufptr = 0;
+    dropping = 1;
+    return;
+  }
+  memcpy(uip.inbuf + inbufptr, data, len);
+  inbufptr += len;
+}
+
+/*
+ * Read from serial in large chunks and unescape them run by run. An ESC
+ * at the end of a chunk is remembered until the next one arrives.
+ */
+static void
+serial_to_tun_bulk(int infd, int outfd)
+{
+  static unsigned char rxbuf[SLIP_READ_SIZE];
+  static int escaped;
+  struct slip_scan scan;
+  const unsigned char *p, *q, *end;
+  ssize_t n;
+  unsigned char c;
+
+  do {
+    n = read(infd, rxbuf, sizeof(rxbuf));
+    if(n == -1 && (errno == EAGAIN || errno == EINTR)) {
+      return;
+    }
+    if(n == -1) {
+      err(1, "serial_to_tun: read");
+    }
+    if(n == 0) {
+#ifdef linux
+      /* The device or the connection is gone */
+      err(1, "serial_to_tun: read");
+#endif
+      return;
+    }
+    PROGRESS(".");
+
+    p = rxbuf;
+    end = rxbuf + n;
+    slip_scan_init(&scan, p, end);
+    while(p < end) {
+      if(escaped) {
+        escaped = 0;
+        switch(c = *p++) {
+        case SLIP_ESC_END:
+          c = SLIP_END;
+          break;
+        case SLIP_ESC_ESC:
+          c = SLIP_ESC;
+          break;
+        case SLIP_ESC_XON:
+          c = XON;
+          break;
+        case SLIP_ESC_XOFF:
+          c = XOFF;
+          break;
+        }
+        slip_input_append(&c, 1);
+        continue;
+      }
+
+      q = slip_scan_next(&scan, p);
+      slip_input_append(p, q - p);
+      if(q == end) {
+        break;
+      }
+      if(*q == SLIP_END) {
+        if(inbufptr > 0) {
+          slip_frame_to_tun(outfd);
+          inbufptr = 0;
+        }
+        dropping = 0;
+      } else {
+        escaped = 1;
+      }
+      p = q + 1;
+    }
+  } while(n == sizeof(rxbuf));
+}
+#endif /* SLIP_BULK */
+
 /*
  * Read from serial, when we have a packet write it to tun. No output
  * buffering, input buffered by stdio.
@@ -172,13 +416,17 @@ is_sensible_string(const unsigned char *s, int len)
 void
 serial_to_tun(FILE *inslip, int outfd)
 {
-  static union {
-    unsigned char inbuf[2000];
-  } uip;
-  static int inbufptr = 0;
-  int ret,i;
+  int ret;
   unsigned char c;
 
+#if SLIP_BULK
+  /* The line echo of the higher verbose levels works byte by byte */
+  if(verbose < 2) {
+    serial_to_tun_bulk(fileno(inslip), outfd);
+    return;
+  }
+#endif /* SLIP_BULK */
+
 #ifdef linux
   ret = fread(&c, 1, 1, inslip);
   if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
@@ -206,84 +454,7 @@ serial_to_tun(FILE *inslip, int outfd)
   switch(c) {
   case SLIP_END:
     if(inbufptr > 0) {
-      if(uip.inbuf[0] == '!') {
-	if(uip.inbuf[1] == 'M') {
-	  /* Read gateway MAC address and autoconfigure tap0 interface */
-	  char macs[24];
-	  int i, pos;
-	  for(i = 0, pos = 0; i < 16; i++) {
-	    macs[pos++] = uip.inbuf[2 + i];
-	    if((i & 1) == 1 && i < 14) {
-	      macs[pos++] = ':';
-	    }
-	  }
-          if(timestamp) stamptime();
-	  macs[pos] = '\0';
-//	  printf("*** Gateway's MAC address: %s\n", macs);
-	  fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s down", tundev);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s up", tundev);
-	}
-      } else if(uip.inbuf[0] == '?') {
-	if(uip.inbuf[1] == 'P') {
-          /* Prefix info requested */
-          struct in6_addr addr;
-	  int i;
-	  char *s = strchr(ipaddr, '/');
-	  if(s != NULL) {
-	    *s = '\0';
-	  }
-          inet_pton(AF_INET6, ipaddr, &addr);
-          if(timestamp) stamptime();
-          fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
-		 ipaddr,
-		 addr.s6_addr[0], addr.s6_addr[1],
-		 addr.s6_addr[2], addr.s6_addr[3],
-		 addr.s6_addr[4], addr.s6_addr[5],
-		 addr.s6_addr[6], addr.s6_addr[7]);
-	  slip_send(slipfd, '!');
-	  slip_send(slipfd, 'P');
-	  for(i = 0; i < 8; i++) {
-	    /* need to call the slip_send_char for stuffing */
-	    slip_send_char(slipfd, addr.s6_addr[i]);
-	  }
-	  slip_send(slipfd, SLIP_END);
-        }
-#define DEBUG_LINE_MARKER '\r'
-      } else if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
-	fwrite(uip.inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(uip.inbuf, inbufptr)) {
-        if(verbose==1) {   /* strings already echoed below for verbose>1 */
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(verbose>2) {
-          if (timestamp) stamptime();
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if (verbose>4) {
-#if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-	        for(i = 0; i < inbufptr; i++) printf(" %02x",uip.inbuf[i]);
-#else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", uip.inbuf[i]);
-              if((i & 3) == 3) printf(" ");
-              if((i & 15) == 15) printf("\n         ");
-            }
-#endif
-            printf("\n");
-          }
-        }
-	if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
-	  err(1, "serial_to_tun: write");
-	}
-      }
+      slip_frame_to_tun(outfd);
       inbufptr = 0;
     }
     break;
@@ -337,7 +508,7 @@ serial_to_tun(FILE *inslip, int outfd)
   goto read_more;
 }
 
-unsigned char slip_buf[2000];
+unsigned char slip_buf[SLIP_BUF_SIZE];
 int slip_end, slip_begin;
 
 void
@@ -384,6 +555,29 @@ slip_send(int fd, unsigned char c)
   slip_end++;
 }
 
+#if SLIP_BULK
+/* Make room for len more bytes at the end of the output buffer */
+static void
+slip_reserve(int len)
+{
+  if(slip_end + len > sizeof(slip_buf) && slip_begin > 0) {
+    /* Reuse the space of the bytes that have already been written */
+    memmove(slip_buf, slip_buf + slip_begin, slip_end - slip_begin);
+    slip_end -= slip_begin;
+    slip_begin = 0;
+  }
+  if(slip_end + len > sizeof(slip_buf)) {
+    err(1, "slip_send overflow");
+  }
+}
+
+static int
+slip_room(void)
+{
+  return sizeof(slip_buf) - slip_end + slip_begin;
+}
+#endif /* SLIP_BULK */
+
 int
 slip_empty()
 {
@@ -416,8 +610,12 @@ slip_flushbuf(int fd)
 void
 write_to_serial(int outfd, void *inbuf, int len)
 {
-  u_int8_t *p = inbuf;
+  const u_int8_t *p = inbuf;
   int i;
+#if SLIP_BULK
+  const unsigned char *q, *end = p + len;
+  struct slip_scan scan;
+#endif
 
   if(verbose>2) {
     if (timestamp) stamptime();
@@ -443,6 +641,29 @@ write_to_serial(int outfd, void *inbuf, int len)
    */
   /* slip_send(outfd, SLIP_END); */
 
+#if SLIP_BULK
+  /* XON and XOFF need escaping too with software flow control */
+  if(!flowcontrol_xonxoff) {
+    /* Worst case: every byte escaped, plus the END */
+    slip_reserve(2 * len + 1);
+    slip_scan_init(&scan, p, end);
+    while(p < end) {
+      q = slip_scan_next(&scan, p);
+      memcpy(slip_buf + slip_end, p, q - p);
+      slip_end += q - p;
+      if(q == end) {
+        break;
+      }
+      slip_buf[slip_end++] = SLIP_ESC;
+      slip_buf[slip_end++] = *q == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
+      p = q + 1;
+    }
+    slip_send(outfd, SLIP_END);
+    PROGRESS("t");
+    return;
+  }
+#endif /* SLIP_BULK */
+
   for(i = 0; i < len; i++) {
     switch(p[i]) {
     case SLIP_END:
@@ -496,6 +717,20 @@ tun_to_serial(int infd, int outfd)
   return size;
 }
 
+#if SLIP_BULK
+/* Does tun have another packet ready? */
+static int
+tun_readable(int fd)
+{
+  struct timeval tv = { 0, 0 };
+  fd_set rset;
+
+  FD_ZERO(&rset);
+  FD_SET(fd, &rset);
+  return select(fd + 1, &rset, NULL, NULL, &tv) > 0;
+}
+#endif /* SLIP_BULK */
+
 void
 stty_telos(int fd)
 {
@@ -1039,6 +1274,14 @@ exit(1);
       if(delaymsec==0) {
         if(slip_empty() && FD_ISSET(tunfd, &rset)) {
           tun_to_serial(tunfd, slipfd);
+#if SLIP_BULK
+          /* Without a delay, queue what else tun has for the same write.
+             Leave room for a 2000 byte packet with every byte escaped. */
+          while(basedelay == 0 && slip_room() >= 2 * 2000 + 1 &&
+                tun_readable(tunfd)) {
+            tun_to_serial(tunfd, slipfd);
+          }
+#endif /* SLIP_BULK */
           slip_flushbuf(slipfd);
           if(ipa_enable) sigalarm_reset();
           if(basedelay) {